@@ -22,30 +22,274 @@
 #include <syspage.h>
 
 
+#if defined(__TARGET_RISCV64) || defined(__aarch64__)
+#define ELF_WORD Elf64_Word
+#define ELF_EHDR Elf64_Ehdr
+#define ELF_PHDR Elf64_Phdr
+#define ELF_SHDR Elf64_Shdr
+#else
+#define ELF_WORD Elf32_Word
+#define ELF_EHDR Elf32_Ehdr
+#define ELF_PHDR Elf32_Phdr
+#define ELF_SHDR Elf32_Shdr
+#endif
+
+/* Size of the calibration read deciding between XIP and copy (-b) */
+#ifndef APP_BEST_CALIB_SZ
+#define APP_BEST_CALIB_SZ 0x4000
+#endif
+
+/* App is copied if its first imap reads at least this many times faster than the device */
+#ifndef APP_BEST_RATIO
+#define APP_BEST_RATIO 2
+#endif
+
+
 static void cmd_appInfo(void)
 {
-	lib_printf("loads app, usage: app [<dev> [-x | -xn] <name> <imap1;imap2...> <dmap1;dmap2...>]");
+	lib_printf("loads app, usage: app [<dev> [-x | -xn] [-b] [-s] <name> <imap1;imap2...> <dmap1;dmap2...>]");
 }
 
 
-static int cmd_cp2ent(handler_t handler, const mapent_t *entry)
+static int cmd_appCopy(handler_t handler, addr_t offs, addr_t dst, size_t sz)
 {
 	ssize_t len;
 	u8 buff[SIZE_MSG_BUFF];
-	size_t offs, sz = entry->end - entry->start;
+	size_t pos;
 
-	for (offs = 0; offs < sz; offs += len) {
-		if ((len = phfs_read(handler, offs, buff, min(SIZE_MSG_BUFF, sz - offs))) < 0) {
+	for (pos = 0; pos < sz; pos += len) {
+		if ((len = phfs_read(handler, offs + pos, buff, min(SIZE_MSG_BUFF, sz - pos))) < 0) {
 			log_error("\nCan't read data");
 			return len;
 		}
-		hal_memcpy((void *)(entry->start + offs), buff, len);
+		else if (len == 0) {
+			log_error("\nUnexpected end of file");
+			return -EIO;
+		}
+		hal_memcpy((void *)(dst + pos), buff, len);
+	}
+
+	return EOK;
+}
+
+
+static int cmd_cp2ent(handler_t handler, const mapent_t *entry)
+{
+	return cmd_appCopy(handler, 0, entry->start, entry->end - entry->start);
+}
+
+
+/*
+ * Segment-aware load: the image contains only the ELF header, program headers, PT_LOAD file contents,
+ * section headers and section names. Segments keep their file offsets modulo min(p_align, SIZE_PAGE),
+ * allocated sections are moved along with their segments and the other sections are emptied.
+ */
+
+static addr_t cmd_appSegOffs(const ELF_PHDR *phdr, addr_t cur, addr_t hdrSz)
+{
+	addr_t align = min((addr_t)phdr->p_align, (addr_t)SIZE_PAGE);
+
+	/* Segment containing the headers stays in place, headers keep their layout */
+	if (phdr->p_offset < hdrSz) {
+		return phdr->p_offset;
+	}
+
+	if (align == 0) {
+		align = 1;
+	}
+
+	return cur + (((addr_t)phdr->p_offset - cur) & (align - 1));
+}
+
+
+static int cmd_appLayout(handler_t handler, const ELF_EHDR *hdr, size_t *size)
+{
+	int res;
+	ELF_WORD i;
+	ELF_PHDR phdr;
+	ELF_SHDR shdr;
+	addr_t offs, cur, hdrSz = sizeof(ELF_EHDR) + hdr->e_phnum * sizeof(ELF_PHDR);
+
+	if ((hdr->e_phoff != sizeof(ELF_EHDR)) || (hdr->e_phentsize != sizeof(ELF_PHDR)) ||
+			((hdr->e_shnum != 0) && ((hdr->e_shentsize != sizeof(ELF_SHDR)) || (hdr->e_shstrndx >= hdr->e_shnum)))) {
+		return -EINVAL;
+	}
+
+	cur = hdrSz;
+	for (i = 0; i < hdr->e_phnum; i++) {
+		if ((res = phfs_read(handler, hdr->e_phoff + i * sizeof(ELF_PHDR), &phdr, sizeof(ELF_PHDR))) < 0) {
+			return res;
+		}
+
+		if ((phdr.p_type != (ELF_WORD)PHT_LOAD) || (phdr.p_filesz == 0)) {
+			continue;
+		}
+
+		offs = cmd_appSegOffs(&phdr, cur, hdrSz);
+		if ((offs < hdrSz) && (cur != hdrSz)) {
+			/* Only the first segment may contain the headers */
+			return -EINVAL;
+		}
+		cur = max(cur, offs + phdr.p_filesz);
 	}
 
+	if (hdr->e_shnum != 0) {
+		if ((res = phfs_read(handler, hdr->e_shoff + hdr->e_shstrndx * sizeof(ELF_SHDR), &shdr, sizeof(ELF_SHDR))) < 0) {
+			return res;
+		}
+
+		cur = ((cur + sizeof(addr_t) - 1) & ~(sizeof(addr_t) - 1)) + hdr->e_shnum * sizeof(ELF_SHDR) + shdr.sh_size;
+	}
+
+	*size = cur;
+
 	return EOK;
 }
 
 
+static addr_t cmd_appAddr2Offs(const ELF_EHDR *hdr, addr_t base, addr_t vaddr, int *found)
+{
+	ELF_WORD i;
+	const ELF_PHDR *phdr = (const ELF_PHDR *)(base + hdr->e_phoff);
+
+	for (i = 0; i < hdr->e_phnum; i++, phdr++) {
+		if ((phdr->p_type == (ELF_WORD)PHT_LOAD) && (vaddr >= phdr->p_vaddr) && (vaddr - phdr->p_vaddr < phdr->p_memsz)) {
+			*found = 1;
+			return phdr->p_offset + (vaddr - phdr->p_vaddr);
+		}
+	}
+
+	*found = 0;
+
+	return 0;
+}
+
+
+static int cmd_appCopySegments(handler_t handler, const ELF_EHDR *hdr, const mapent_t *entry)
+{
+	int res, found;
+	ELF_WORD i;
+	ELF_PHDR *phdr;
+	ELF_SHDR *shdr;
+	ELF_EHDR *ehdr = (ELF_EHDR *)entry->start;
+	addr_t offs, strOffs, cur, hdrSz = sizeof(ELF_EHDR) + hdr->e_phnum * sizeof(ELF_PHDR);
+
+	/* Headers first - a segment starting at the file beginning overwrites them with identical data */
+	if ((res = cmd_appCopy(handler, 0, entry->start, hdrSz)) < 0) {
+		return res;
+	}
+
+	cur = hdrSz;
+	phdr = (ELF_PHDR *)(entry->start + hdr->e_phoff);
+	for (i = 0; i < hdr->e_phnum; i++, phdr++) {
+		if ((phdr->p_type != (ELF_WORD)PHT_LOAD) || (phdr->p_filesz == 0)) {
+			continue;
+		}
+
+		offs = cmd_appSegOffs(phdr, cur, hdrSz);
+		if ((res = cmd_appCopy(handler, phdr->p_offset, entry->start + offs, phdr->p_filesz)) < 0) {
+			return res;
+		}
+		phdr->p_offset = offs;
+		cur = max(cur, offs + phdr->p_filesz);
+	}
+
+	/* Remaining program headers refer to data inside loadable segments or to nothing */
+	phdr = (ELF_PHDR *)(entry->start + hdr->e_phoff);
+	for (i = 0; i < hdr->e_phnum; i++, phdr++) {
+		if ((phdr->p_type == (ELF_WORD)PHT_LOAD) && (phdr->p_filesz != 0)) {
+			continue;
+		}
+		else if (phdr->p_type == (ELF_WORD)PHT_PHDR) {
+			phdr->p_offset = hdr->e_phoff;
+			continue;
+		}
+
+		offs = cmd_appAddr2Offs(hdr, entry->start, phdr->p_vaddr, &found);
+		phdr->p_offset = offs;
+		if (found == 0) {
+			phdr->p_filesz = 0;
+		}
+	}
+
+	ehdr->e_shoff = 0;
+	if (hdr->e_shnum == 0) {
+		return EOK;
+	}
+
+	cur = (cur + sizeof(addr_t) - 1) & ~(sizeof(addr_t) - 1);
+	if ((res = cmd_appCopy(handler, hdr->e_shoff, entry->start + cur, hdr->e_shnum * sizeof(ELF_SHDR))) < 0) {
+		return res;
+	}
+	ehdr->e_shoff = cur;
+
+	shdr = (ELF_SHDR *)(entry->start + cur);
+	strOffs = cur + hdr->e_shnum * sizeof(ELF_SHDR);
+	if ((res = cmd_appCopy(handler, shdr[hdr->e_shstrndx].sh_offset, entry->start + strOffs, shdr[hdr->e_shstrndx].sh_size)) < 0) {
+		return res;
+	}
+
+	for (i = 0; i < hdr->e_shnum; i++, shdr++) {
+		if (i == hdr->e_shstrndx) {
+			shdr->sh_offset = strOffs;
+		}
+		else if ((shdr->sh_flags & SHF_ALLOC) != 0) {
+			shdr->sh_offset = cmd_appAddr2Offs(hdr, entry->start, shdr->sh_addr, &found);
+		}
+		else if (shdr->sh_type != SHT_NULL) {
+			/* Not loaded (symbols, debug info) */
+			shdr->sh_offset = 0;
+			shdr->sh_size = 0;
+		}
+	}
+
+	return EOK;
+}
+
+
+/* Returns time [us] of reading len bytes from memory, at least 1 */
+static time_t cmd_appReadTime(addr_t start, size_t len)
+{
+	volatile const u32 *p = (volatile const u32 *)start;
+	size_t i;
+	u32 sum = 0;
+	time_t t;
+
+	t = hal_timerGetUs();
+	for (i = 0; i < len / sizeof(u32); i++) {
+		sum += p[i];
+	}
+	t = hal_timerGetUs() - t;
+	(void)sum;
+
+	return (t > 0) ? t : 1;
+}
+
+
+/* Decides whether app mapped at xip is executed in place or copied to imap */
+static int cmd_appBestCopy(const char *name, addr_t xip, size_t size, const char *imap, addr_t start, addr_t end)
+{
+	size_t len = min(min(size, (size_t)(end - start)), (size_t)APP_BEST_CALIB_SZ);
+	time_t xipTime, memTime;
+	int copy;
+
+	/* Nothing to calibrate or map can't hold the image */
+	if ((len < sizeof(u32)) || (size > end - start)) {
+		return 0;
+	}
+
+	/* Device first, so that the image is not yet cached */
+	xipTime = cmd_appReadTime(xip, len);
+	memTime = cmd_appReadTime(start, len);
+	copy = (xipTime >= memTime * APP_BEST_RATIO) ? 1 : 0;
+
+	log_info("\n%s: %zu B read in %u us in place, %u us from %s, %s", name, len, (unsigned int)xipTime, (unsigned int)memTime, imap,
+		(copy != 0) ? "copying" : "executing in place");
+
+	return copy;
+}
+
+
 static int cmd_mapsAdd2Prog(u8 *mapIDs, size_t nb, const char *mapNames)
 {
 	u8 id;
@@ -81,10 +325,11 @@ static size_t cmd_mapsParse(char *maps, char sep)
 }
 
 
-static int cmd_appLoad(handler_t handler, size_t size, const char *name, char *imaps, char *dmaps, const char *appArgv, u32 flags)
+static int cmd_appLoad(handler_t handler, size_t size, const char *name, char *imaps, char *dmaps, const char *appArgv, u32 flags, int segments, int best)
 {
 	int res;
-	Elf32_Ehdr hdr;
+	ELF_EHDR hdr;
+	size_t imgSz = size;
 
 	unsigned int attr;
 	size_t dmapSz, imapSz;
@@ -94,7 +339,7 @@ static int cmd_appLoad(handler_t handler, size_t size, const char *name, char *i
 	const mapent_t *entry;
 
 	/* Check ELF header */
-	if ((res = phfs_read(handler, 0, &hdr, sizeof(Elf32_Ehdr))) < 0) {
+	if ((res = phfs_read(handler, 0, &hdr, sizeof(ELF_EHDR))) < 0) {
 		log_error("\nCan't read data");
 		return res;
 	}
@@ -123,6 +368,16 @@ static int cmd_appLoad(handler_t handler, size_t size, const char *name, char *i
 		return res;
 	}
 
+	if (best != 0) {
+		if ((res == dev_isMappable) && (cmd_appBestCopy(name, addr + offs, size, imaps, start, end) == 0)) {
+			flags |= flagSyspageNoCopy;
+		}
+		else {
+			/* Copied like from a not mappable device */
+			res = dev_isNotMappable;
+		}
+	}
+
 	if (res == dev_isMappable || (res == dev_isNotMappable && (flags & flagSyspageNoCopy) != 0)) {
 		if ((entry = syspage_entryAdd(NULL, addr + offs, size, SIZE_PAGE)) == NULL) {
 			log_error("\nCannot allocate memory for %s", name);
@@ -130,13 +385,20 @@ static int cmd_appLoad(handler_t handler, size_t size, const char *name, char *i
 		}
 	}
 	else if (res == dev_isNotMappable) {
-		if ((entry = syspage_entryAdd(imaps, (addr_t)-1, size, SIZE_PAGE)) == NULL) {
+		if ((segments != 0) && (cmd_appLayout(handler, &hdr, &imgSz) < 0)) {
+			log_info("\n%s: Unsupported ELF layout, loading whole file", name);
+			segments = 0;
+			imgSz = size;
+		}
+
+		if ((entry = syspage_entryAdd(imaps, (addr_t)-1, imgSz, SIZE_PAGE)) == NULL) {
 			log_error("\nCannot allocate memory for %s", name);
 			return -ENOMEM;
 		}
 
-		/* Copy elf file to selected entry */
-		if ((res = cmd_cp2ent(handler, entry)) < 0)
+		/* Copy elf file or its loadable segments to selected entry */
+		res = (segments != 0) ? cmd_appCopySegments(handler, &hdr, entry) : cmd_cp2ent(handler, entry);
+		if (res < 0)
 			return res;
 	}
 	else {
@@ -168,7 +430,7 @@ static int cmd_appLoad(handler_t handler, size_t size, const char *name, char *i
 static int cmd_app(int argc, char *argv[])
 {
 	size_t pos;
-	int res, argvID = 0;
+	int res, argvID = 0, segments = 0, best = 0;
 
 	char *imaps, *dmaps;
 	unsigned int flags = 0;
@@ -184,7 +446,7 @@ static int cmd_app(int argc, char *argv[])
 		syspage_progShow();
 		return CMD_EXIT_SUCCESS;
 	}
-	else if (argc < 5 || argc > 6) {
+	else if (argc < 5 || argc > 8) {
 		log_error("\n%s: Wrong argument count", argv[0]);
 		return CMD_EXIT_FAILURE;
 	}
@@ -195,19 +457,31 @@ static int cmd_app(int argc, char *argv[])
 
 	/* ARG_2: optional flags */
 	argvID = 2;
-	if (argv[argvID][0] == '-') {
+	while ((argvID < argc) && (argv[argvID][0] == '-')) {
 		if ((argv[argvID][1] | 0x20) == 'x' && argv[argvID][2] == '\0') {
 			flags |= flagSyspageExec;
-			argvID++;
 		}
 		else if ((argv[argvID][1] | 0x20) == 'x' && (argv[argvID][2] | 0x20) == 'n' && argv[argvID][3] == '\0') {
 			flags |= flagSyspageExec | flagSyspageNoCopy;
-			argvID++;
+		}
+		else if ((argv[argvID][1] | 0x20) == 'b' && argv[argvID][2] == '\0') {
+			/* XIP or copy, whichever is faster */
+			best = 1;
+		}
+		else if ((argv[argvID][1] | 0x20) == 's' && argv[argvID][2] == '\0') {
+			/* Copy only loadable segments */
+			segments = 1;
 		}
 		else {
 			log_error("\n%s: Wrong arguments", argv[0]);
 			return CMD_EXIT_FAILURE;
 		}
+		argvID++;
+	}
+
+	if ((best != 0) && ((flags & flagSyspageNoCopy) != 0)) {
+		log_error("\n%s: -b and -xn are exclusive", argv[0]);
+		return CMD_EXIT_FAILURE;
 	}
 
 	if (argvID != (argc - 3)) {
@@ -246,7 +520,7 @@ static int cmd_app(int argc, char *argv[])
 		return CMD_EXIT_FAILURE;
 	}
 
-	res = cmd_appLoad(handler, stat.size, name, imaps, dmaps, appArgv, flags);
+	res = cmd_appLoad(handler, stat.size, name, imaps, dmaps, appArgv, flags, segments, best);
 	if (res < 0) {
 		log_error("\nCan't load %s to %s via %s (%d)", name, imaps, argv[1], res);
 		phfs_close(handler);
@@ -0,0 +1,432 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Operating system loader
+ *
+ * Device throughput benchmark
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#include <hal/hal.h>
+#include <lib/lib.h>
+#include <devices/devs.h>
+
+#include "cmd.h"
+
+
+#define BENCH_DEV_TIMEOUT_MS 500u
+
+#define BENCH_WRITE 1u
+#define BENCH_ERASE 2u
+
+#define BENCH_CHUNK_MIN   512u
+#define BENCH_BUF_SIZE    0x4000u /* Largest chunk size in the sweep */
+#define BENCH_HIST_SUB    8u      /* Histogram buckets per power of two, bounds percentile error to 1/8 */
+#define BENCH_HIST_SIZE   ((32u - 2u) * BENCH_HIST_SUB)
+#define BENCH_RANDOM_SEED 0x12345678u
+#define BENCH_TIME_UNIT   "us"
+
+
+typedef struct {
+	u32 hist[BENCH_HIST_SIZE]; /* Per-call latencies on log scale, covers every call */
+	u32 max;
+	size_t calls;
+	u64 bytes;
+	time_t total;
+} bench_stat_t;
+
+
+static struct {
+	u8 buf[BENCH_BUF_SIZE];
+	bench_stat_t stat;
+	u32 seed;
+} bench_common;
+
+
+static void cmd_benchDevInfo(void)
+{
+	lib_consolePuts("measures device throughput and latency, usage: bench-dev [-w] [-e] -d <dev> [-s <addr>] -l <length> [-c <chunk>]");
+}
+
+
+static void cmd_benchDevUsage(void)
+{
+	/* clang-format off */
+	lib_consolePuts("Usage: bench-dev [-w] [-e] -d <major>.<minor> [-s <addr>] -l <length> [-c <chunk>]\n"
+	"  -w       Benchmark write and sync (destroys data in range)\n"
+	"  -e       Benchmark erase (destroys data in range)\n"
+	"  -s       Start address, default: 0\n"
+	"  -l       Length of the tested range\n"
+	"  -c       Test only the given chunk size instead of sweeping\n"
+	);
+	/* clang-format on */
+}
+
+
+static time_t cmd_benchTime(void)
+{
+	return hal_timerGetUs();
+}
+
+
+/* Simple LCG, deterministic between runs to make results comparable */
+static u32 cmd_benchRand(void)
+{
+	bench_common.seed = bench_common.seed * 1664525u + 1013904223u;
+
+	return bench_common.seed;
+}
+
+
+static void cmd_benchStatReset(bench_stat_t *stat)
+{
+	hal_memset(stat->hist, 0, sizeof(stat->hist));
+	stat->max = 0;
+	stat->calls = 0;
+	stat->bytes = 0;
+	stat->total = 0;
+}
+
+
+/* Values below BENCH_HIST_SUB get own buckets, then each power of two is split into BENCH_HIST_SUB buckets */
+static unsigned int cmd_benchHistIdx(u32 v)
+{
+	unsigned int e;
+
+	if (v < BENCH_HIST_SUB) {
+		return v;
+	}
+
+	e = 31u - __builtin_clz(v);
+
+	return (e - 2u) * BENCH_HIST_SUB + ((v >> (e - 3u)) & (BENCH_HIST_SUB - 1u));
+}
+
+
+/* Returns the largest value falling into the bucket */
+static u32 cmd_benchHistVal(unsigned int idx)
+{
+	unsigned int e;
+
+	if (idx < BENCH_HIST_SUB) {
+		return idx;
+	}
+
+	e = idx / BENCH_HIST_SUB + 2u;
+
+	/* Wraps to 0xffffffff for the last bucket */
+	return ((BENCH_HIST_SUB + 1u + (idx % BENCH_HIST_SUB)) << (e - 3u)) - 1u;
+}
+
+
+static void cmd_benchStatAdd(bench_stat_t *stat, time_t t, size_t bytes)
+{
+	u32 v = (t > 0xffffffffu) ? 0xffffffffu : (u32)t;
+
+	stat->hist[cmd_benchHistIdx(v)]++;
+	if (v > stat->max) {
+		stat->max = v;
+	}
+	stat->calls++;
+	stat->bytes += bytes;
+	stat->total += t;
+}
+
+
+static u32 cmd_benchPercentile(const bench_stat_t *stat, unsigned int pct)
+{
+	unsigned int i;
+	u64 rank, sum = 0;
+
+	if (stat->calls == 0) {
+		return 0;
+	}
+
+	rank = ((u64)stat->calls * pct) / 100u;
+	for (i = 0; i < BENCH_HIST_SIZE; ++i) {
+		sum += stat->hist[i];
+		if (sum > rank) {
+			break;
+		}
+	}
+
+	return (i < BENCH_HIST_SIZE) ? min(cmd_benchHistVal(i), stat->max) : stat->max;
+}
+
+
+static void cmd_benchStatShow(const char *name, size_t chunk, const bench_stat_t *stat)
+{
+	u64 rate;
+	time_t total = (stat->total != 0) ? stat->total : 1;
+
+	/* bytes per ms equals kB/s */
+	rate = (stat->bytes * 1000u) / total;
+
+	lib_printf("%-6s %7zu %7zu %5llu.%02llu MB/s  p50 %u p90 %u p99 %u max %u " BENCH_TIME_UNIT "\n",
+		name, chunk, stat->calls, rate / 1000u, (rate % 1000u) / 10u,
+		cmd_benchPercentile(stat, 50), cmd_benchPercentile(stat, 90), cmd_benchPercentile(stat, 99), stat->max);
+}
+
+
+static int cmd_benchRead(unsigned int major, unsigned int minor, addr_t start, size_t length, size_t chunk, int random)
+{
+	ssize_t res;
+	size_t pos, n, cnt = length / chunk;
+	addr_t offs;
+	time_t t;
+
+	cmd_benchStatReset(&bench_common.stat);
+
+	for (n = 0; n < cnt; ++n) {
+		pos = (random != 0) ? (cmd_benchRand() % cnt) : n;
+		offs = start + pos * chunk;
+
+		t = cmd_benchTime();
+		res = devs_read(major, minor, offs, bench_common.buf, chunk, BENCH_DEV_TIMEOUT_MS);
+		t = cmd_benchTime() - t;
+		if (res < 0) {
+			log_error("\nCan't read data at 0x%x %zd\n", offs, res);
+			return res;
+		}
+		cmd_benchStatAdd(&bench_common.stat, t, res);
+	}
+
+	cmd_benchStatShow((random != 0) ? "rdrand" : "rdseq", chunk, &bench_common.stat);
+
+	return EOK;
+}
+
+
+static int cmd_benchWrite(unsigned int major, unsigned int minor, addr_t start, size_t length, size_t chunk, int random)
+{
+	ssize_t res;
+	size_t pos, n, cnt = length / chunk;
+	addr_t offs;
+	time_t t;
+
+	cmd_benchStatReset(&bench_common.stat);
+
+	for (n = 0; n < chunk; ++n) {
+		bench_common.buf[n] = (u8)n;
+	}
+
+	/* Random writes go to distinct chunks, flash-like devices can't be programmed twice */
+	for (n = 0; n < cnt; ++n) {
+		pos = (random != 0) ? (size_t)(((u64)n * 2654435761u) % cnt) : n;
+		offs = start + pos * chunk;
+
+		t = cmd_benchTime();
+		res = devs_write(major, minor, offs, bench_common.buf, chunk);
+		t = cmd_benchTime() - t;
+		if (res < 0) {
+			log_error("\nCan't write data at 0x%x %zd\n", offs, res);
+			return res;
+		}
+		cmd_benchStatAdd(&bench_common.stat, t, res);
+	}
+
+	t = cmd_benchTime();
+	res = devs_sync(major, minor);
+	t = cmd_benchTime() - t;
+	if ((res < 0) && (res != -ENOSYS)) {
+		log_error("\nSync failed %zd\n", res);
+		return res;
+	}
+
+	/* Pending data is written by sync, so include it in the throughput */
+	bench_common.stat.total += t;
+	cmd_benchStatShow((random != 0) ? "wrrand" : "wrseq", chunk, &bench_common.stat);
+	lib_printf("%-6s %7s %7u %15s  %u " BENCH_TIME_UNIT "\n", "sync", "-", 1u, "", (u32)t);
+
+	return EOK;
+}
+
+
+static int cmd_benchErase(unsigned int major, unsigned int minor, addr_t start, size_t length, size_t chunk)
+{
+	ssize_t res;
+	size_t n, cnt = length / chunk;
+	time_t t;
+
+	cmd_benchStatReset(&bench_common.stat);
+
+	for (n = 0; n < cnt; ++n) {
+		t = cmd_benchTime();
+		res = devs_erase(major, minor, start + n * chunk, chunk, 0);
+		t = cmd_benchTime() - t;
+		if (res < 0) {
+			log_error("\nErase failed at 0x%x %zd\n", start + n * chunk, res);
+			return res;
+		}
+		cmd_benchStatAdd(&bench_common.stat, t, chunk);
+	}
+
+	cmd_benchStatShow("erase", chunk, &bench_common.stat);
+
+	return EOK;
+}
+
+
+static int cmd_doBenchDev(unsigned int major, unsigned int minor, addr_t start, size_t length, size_t chunk, u8 mode)
+{
+	int res, random;
+	size_t chunkMin, chunkMax, erasesz = 0;
+
+	if (devs_check(major, minor) < 0) {
+		log_error("\nInvalid device %u.%u\n", major, minor);
+		return -EINVAL;
+	}
+
+	/* Erase must respect the device erase block, sweep doesn't apply to it.
+	 * Without the block size property the whole range is erased by a single call */
+	if ((mode & BENCH_ERASE) != 0u) {
+		if ((devs_control(major, minor, DEV_CONTROL_GETPROP_BLOCKSZ, &erasesz) < 0) || (erasesz == 0u)) {
+			erasesz = length;
+		}
+		if (((start % erasesz) != 0u) || (length < erasesz)) {
+			log_error("\nRange not aligned to erase block 0x%zx\n", erasesz);
+			return -EINVAL;
+		}
+	}
+
+	chunkMin = (chunk != 0u) ? chunk : BENCH_CHUNK_MIN;
+	chunkMax = (chunk != 0u) ? chunk : BENCH_BUF_SIZE;
+
+	lib_printf("\nDevice %u.%u range 0x%x-0x%x\n", major, minor, start, start + length);
+	lib_printf(CONSOLE_BOLD "%-6s %7s %7s %15s  %s\n" CONSOLE_NORMAL, "OP", "CHUNK", "CALLS", "THROUGHPUT", "LATENCY");
+
+	for (chunk = chunkMin; (chunk <= chunkMax) && (chunk <= length); chunk <<= 1) {
+		for (random = 0; random < 2; ++random) {
+			bench_common.seed = BENCH_RANDOM_SEED;
+
+			if ((mode & BENCH_WRITE) != 0u) {
+				if (erasesz != 0u) {
+					res = cmd_benchErase(major, minor, start, length, erasesz);
+					if (res < 0) {
+						return res;
+					}
+				}
+
+				res = cmd_benchWrite(major, minor, start, length, chunk, random);
+				if (res < 0) {
+					return res;
+				}
+			}
+
+			res = cmd_benchRead(major, minor, start, length, chunk, random);
+			if (res < 0) {
+				return res;
+			}
+		}
+	}
+
+	if (((mode & BENCH_WRITE) == 0u) && (erasesz != 0u)) {
+		return cmd_benchErase(major, minor, start, length, erasesz);
+	}
+
+	return EOK;
+}
+
+
+static int cmd_benchDev(int argc, char *argv[])
+{
+	int opt, err;
+	unsigned int major = (unsigned int)-1, minor = 0;
+	u8 mode = 0;
+	char *endptr;
+	addr_t start = 0;
+	size_t length = 0, chunk = 0;
+
+	for (;;) {
+		opt = lib_getopt(argc, argv, "wed:s:l:c:");
+		if (opt < 0) {
+			break;
+		}
+		switch (opt) {
+			case 'w':
+				mode |= BENCH_WRITE;
+				break;
+
+			case 'e':
+				mode |= BENCH_ERASE;
+				break;
+
+			case 'd':
+				major = lib_strtoul(optarg, &endptr, 0);
+				if (*endptr != '.') {
+					log_error("\nInvalid device.\n");
+					cmd_benchDevUsage();
+					return CMD_EXIT_FAILURE;
+				}
+				minor = lib_strtoul(endptr + 1, &endptr, 0);
+				if (*endptr != '\0') {
+					log_error("\nInvalid device.\n");
+					cmd_benchDevUsage();
+					return CMD_EXIT_FAILURE;
+				}
+				break;
+
+			case 's':
+				start = lib_strtoul(optarg, &endptr, 0);
+				if (*endptr != '\0') {
+					log_error("\nInvalid start.\n");
+					cmd_benchDevUsage();
+					return CMD_EXIT_FAILURE;
+				}
+				break;
+
+			case 'l':
+				length = lib_strtoul(optarg, &endptr, 0);
+				if ((*endptr != '\0') || (length == 0u)) {
+					log_error("\nInvalid length.\n");
+					cmd_benchDevUsage();
+					return CMD_EXIT_FAILURE;
+				}
+				break;
+
+			case 'c':
+				chunk = lib_strtoul(optarg, &endptr, 0);
+				if ((*endptr != '\0') || (chunk == 0u) || (chunk > BENCH_BUF_SIZE)) {
+					log_error("\nInvalid chunk, max 0x%x.\n", BENCH_BUF_SIZE);
+					cmd_benchDevUsage();
+					return CMD_EXIT_FAILURE;
+				}
+				break;
+
+			default:
+				cmd_benchDevUsage();
+				return CMD_EXIT_FAILURE;
+		}
+	}
+
+	if (major == (unsigned int)-1) {
+		log_error("\nDevice missing.\n");
+		return CMD_EXIT_FAILURE;
+	}
+	if (length == 0u) {
+		log_error("\nLength missing.\n");
+		return CMD_EXIT_FAILURE;
+	}
+	if ((start + length) < start) {
+		log_error("\nStart + length causes overflow.\n");
+		return CMD_EXIT_FAILURE;
+	}
+
+	err = cmd_doBenchDev(major, minor, start, length, chunk, mode);
+	if (err < 0) {
+		log_error("\nError: %d\n", err);
+		return CMD_EXIT_FAILURE;
+	}
+
+	return CMD_EXIT_SUCCESS;
+}
+
+
+static const cmd_t benchdev_cmd __attribute__((section("commands"), used)) = {
+	.name = "bench-dev", .run = cmd_benchDev, .info = cmd_benchDevInfo
+};
@@ -127,6 +127,7 @@ int cmd_parse(const char *script)
 				lib_getoptReset();
 
 				ret = cmd->run(argc, argv);
+				lib_consoleFlush();
 				if (ret != CMD_EXIT_SUCCESS) {
 					return (ret < 0) ? ret : -EINVAL;
 				}
@@ -15,6 +15,7 @@
 
 #include "cmd.h"
 
+#include <devices/devs.h>
 #include <hal/hal.h>
 #include <lib/lib.h>
 
@@ -44,6 +45,19 @@ static int cmd_consoleParse(char *s, unsigned int *major, unsigned int *minor)
 }
 
 
+/* Consoles are initialized at once, so that input is not lost until the first access */
+static int cmd_consoleInit(const char *name, unsigned int major, unsigned int minor)
+{
+	int res = devs_initDevice(major, minor);
+
+	if (res < 0) {
+		log_error("\n%s: Cannot initialize device %u.%u (%d)", name, major, minor, res);
+	}
+
+	return res;
+}
+
+
 static int cmd_console(int argc, char *argv[])
 {
 	unsigned int major, minor;
@@ -70,6 +84,16 @@ static int cmd_console(int argc, char *argv[])
 		}
 	}
 
+	if (cmd_consoleInit(argv[0], major, minor) < 0) {
+		return CMD_EXIT_FAILURE;
+	}
+
+	for (i = 0; (i + 2) < argc; i++) {
+		if (cmd_consoleInit(argv[0], mirrorMajors[i], mirrorMinors[i]) < 0) {
+			return CMD_EXIT_FAILURE;
+		}
+	}
+
 	lib_printf("\nconsole: Setting console to %u.%u", major, minor);
 	if (argc > 2) {
 		lib_printf("\nconsole: Setting console mirrors to %d.%d", mirrorMajors[0], mirrorMinors[0]);
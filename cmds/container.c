@@ -0,0 +1,358 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Operating system loader
+ *
+ * Load multi-image container
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#include "cmd.h"
+#include "container.h"
+
+#include <lib/lib.h>
+#include <hal/hal.h>
+#include <phfs/phfs.h>
+#include <syspage.h>
+#include <warmboot.h>
+
+
+static struct {
+	container_ent_t ents[CONTAINER_MAX_ENTRIES];
+	u8 order[CONTAINER_MAX_ENTRIES];
+} container_common;
+
+
+static void cmd_containerInfo(void)
+{
+	lib_printf("loads apps and blobs from container in a single pass, usage: container [<dev> <name>]");
+}
+
+
+static u32 cmd_containerCrc(const void *data, size_t len)
+{
+	return ~lib_crc32(data, len, 0xffffffff);
+}
+
+
+/* Reads exactly len bytes, transports may return partial transfers */
+static int cmd_containerRead(handler_t handler, addr_t offs, void *buff, size_t len)
+{
+	ssize_t res;
+	size_t pos;
+
+	for (pos = 0; pos < len; pos += res) {
+		res = phfs_read(handler, offs + pos, (u8 *)buff + pos, len - pos);
+		if (res < 0) {
+			log_error("\nCan't read data");
+			return res;
+		}
+		else if (res == 0) {
+			log_error("\nUnexpected end of file");
+			return -EIO;
+		}
+	}
+
+	return EOK;
+}
+
+
+static size_t cmd_containerMapsParse(char *maps)
+{
+	size_t nb = 0;
+
+	while (*maps != '\0') {
+		if (*maps == ';') {
+			*maps = '\0';
+			++nb;
+		}
+		maps++;
+	}
+
+	return ++nb;
+}
+
+
+static int cmd_containerMapsAdd(u8 **mapIDs, size_t nb, const char *mapNames)
+{
+	int res;
+	size_t i;
+
+	*mapIDs = syspage_alloc(nb * sizeof(u8));
+	if (*mapIDs == NULL) {
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < nb; ++i) {
+		res = syspage_mapNameResolve(mapNames, &(*mapIDs)[i]);
+		if (res < 0) {
+			log_error("\nCan't add map %s", mapNames);
+			return res;
+		}
+		mapNames += hal_strlen(mapNames) + 1; /* name + '\0' */
+	}
+
+	return EOK;
+}
+
+
+static int cmd_containerProgAdd(const container_ent_t *ent, const mapent_t *entry, size_t imapSz, size_t dmapSz)
+{
+	syspage_prog_t *prog;
+	int res;
+
+	if (ent->type == container_blob) {
+		prog = syspage_progAdd(ent->name, 0);
+		if (prog == NULL) {
+			return -ENOMEM;
+		}
+
+		prog->imaps = NULL;
+		prog->imapSz = 0;
+		prog->dmaps = NULL;
+		prog->dmapSz = 0;
+	}
+	else {
+		prog = syspage_progAdd(ent->name, ent->flags);
+		if (prog == NULL) {
+			return -ENOMEM;
+		}
+
+		res = cmd_containerMapsAdd(&prog->imaps, imapSz, ent->imaps);
+		if (res < 0) {
+			return res;
+		}
+
+		res = cmd_containerMapsAdd(&prog->dmaps, dmapSz, ent->dmaps);
+		if (res < 0) {
+			return res;
+		}
+
+		prog->imapSz = imapSz;
+		prog->dmapSz = dmapSz;
+	}
+
+	prog->start = entry->start;
+	prog->end = entry->end;
+
+	return EOK;
+}
+
+
+static int cmd_containerLoad(handler_t handler, addr_t base, container_ent_t *ent, const char *name)
+{
+	int res, mode;
+	unsigned int attr;
+	size_t imapSz, dmapSz;
+	addr_t start, end, addr;
+	const mapent_t *entry;
+	const u8 *elf;
+	warmboot_src_t src;
+
+	mode = (ent->type == container_app) ? (mAttrRead | mAttrExec) : mAttrRead;
+
+	/* Image is placed in the first map */
+	imapSz = cmd_containerMapsParse(ent->imaps);
+	dmapSz = cmd_containerMapsParse(ent->dmaps);
+	if ((syspage_mapAttrResolve(ent->imaps, &attr) < 0) || (syspage_mapRangeResolve(ent->imaps, &start, &end) < 0)) {
+		log_error("\n%s does not exist", ent->imaps);
+		return -EINVAL;
+	}
+
+	res = phfs_map(handler, base + ent->offs, ent->size, mode, start, end - start, attr, &addr);
+	if (res < 0) {
+		log_error("\nDevice is not mappable in %s", ent->imaps);
+		return res;
+	}
+
+	if ((res == dev_isMappable) || ((res == dev_isNotMappable) && ((ent->flags & flagSyspageNoCopy) != 0))) {
+		entry = syspage_entryAdd(NULL, addr + base + ent->offs, ent->size, SIZE_PAGE);
+		if (entry == NULL) {
+			log_error("\nCannot allocate memory for %s", name);
+			return -ENOMEM;
+		}
+
+		if (res == dev_isNotMappable) {
+			/* Image is not accessible to verify */
+			return cmd_containerProgAdd(ent, entry, imapSz, dmapSz);
+		}
+	}
+	else if (res == dev_isNotMappable) {
+		entry = syspage_entryAdd(ent->imaps, (addr_t)-1, ent->size, SIZE_PAGE);
+		if (entry == NULL) {
+			log_error("\nCannot allocate memory for %s", name);
+			return -ENOMEM;
+		}
+
+		/* Image crc from the table identifies the stored content */
+		warmboot_srcInit(handler, ent->offs, ent->crc, &src);
+
+		/* Read image directly to the selected entry unless it survived the warm reset */
+		if (warmboot_check(name, entry->start, ent->size, &src) != EOK) {
+			res = cmd_containerRead(handler, ent->offs, (void *)entry->start, ent->size);
+			if (res < 0) {
+				return res;
+			}
+			warmboot_add(name, entry->start, ent->size, &src);
+		}
+	}
+	else {
+		log_error("\nDevice mappable routine failed");
+		return -ENOMEM;
+	}
+
+	if (cmd_containerCrc((const void *)entry->start, ent->size) != ent->crc) {
+		log_error("\n%s: Checksum mismatch", name);
+		return -EIO;
+	}
+
+	elf = (const u8 *)entry->start;
+	if ((ent->type == container_app) && ((ent->size < 4) || (elf[0] != 0x7f) || (elf[1] != 'E') || (elf[2] != 'L') || (elf[3] != 'F'))) {
+		log_error("\n%s isn't an ELF object", name);
+		return -EIO;
+	}
+
+	return cmd_containerProgAdd(ent, entry, imapSz, dmapSz);
+}
+
+
+static int cmd_containerTable(handler_t handler, size_t fileSz, unsigned int *count)
+{
+	int res;
+	unsigned int i, j;
+	container_hdr_t hdr;
+	container_ent_t *ent;
+
+	res = cmd_containerRead(handler, 0, &hdr, sizeof(hdr));
+	if (res < 0) {
+		return res;
+	}
+
+	if ((hdr.magic != CONTAINER_MAGIC) || (hdr.version != CONTAINER_VERSION)) {
+		log_error("\nFile isn't a container");
+		return -EINVAL;
+	}
+
+	if ((hdr.count > CONTAINER_MAX_ENTRIES) || (hdr.size != sizeof(hdr) + hdr.count * sizeof(container_ent_t)) || (hdr.size > fileSz)) {
+		log_error("\nUnsupported container layout (%u entries)", hdr.count);
+		return -EINVAL;
+	}
+
+	res = cmd_containerRead(handler, sizeof(hdr), container_common.ents, hdr.count * sizeof(container_ent_t));
+	if (res < 0) {
+		return res;
+	}
+
+	if (cmd_containerCrc(container_common.ents, hdr.count * sizeof(container_ent_t)) != hdr.crc) {
+		log_error("\nContainer table checksum mismatch");
+		return -EIO;
+	}
+
+	for (i = 0; i < hdr.count; i++) {
+		ent = &container_common.ents[i];
+		if ((ent->offs < hdr.size) || (ent->offs > fileSz) || (ent->size > fileSz - ent->offs) ||
+				((ent->type != container_app) && (ent->type != container_blob))) {
+			log_error("\nInvalid container entry %u", i);
+			return -EINVAL;
+		}
+
+		ent->name[sizeof(ent->name) - 1] = '\0';
+		ent->imaps[sizeof(ent->imaps) - 1] = '\0';
+		ent->dmaps[sizeof(ent->dmaps) - 1] = '\0';
+
+		/* Insertion sort by offset, images are read strictly sequentially */
+		for (j = i; (j > 0) && (container_common.ents[container_common.order[j - 1]].offs > ent->offs); j--) {
+			container_common.order[j] = container_common.order[j - 1];
+		}
+		container_common.order[j] = i;
+	}
+
+	*count = hdr.count;
+
+	return EOK;
+}
+
+
+static int cmd_container(int argc, char *argv[])
+{
+	int res;
+	size_t pos, total = 0;
+	unsigned int i, count;
+	addr_t base;
+	char name[sizeof(container_common.ents[0].name)];
+	container_ent_t *ent;
+
+	handler_t handler;
+	phfs_stat_t stat;
+
+	/* Parse command arguments */
+	if (argc == 1) {
+		syspage_progShow();
+		return CMD_EXIT_SUCCESS;
+	}
+	if (argc != 3) {
+		log_error("\n%s: Wrong argument count", argv[0]);
+		return CMD_EXIT_FAILURE;
+	}
+
+	/* Open file */
+	res = phfs_open(argv[1], argv[2], 0, &handler);
+	if (res < 0) {
+		log_error("\nCan't open %s on %s (%d)", argv[2], argv[1], res);
+		return CMD_EXIT_FAILURE;
+	}
+
+	/* Get file's properties */
+	res = phfs_stat(handler, &stat);
+	if (res < 0) {
+		log_error("\nCan't get stat from %s (%d)", argv[2], res);
+		phfs_close(handler);
+		return CMD_EXIT_FAILURE;
+	}
+
+	if (phfs_aliasAddrResolve(handler, &base) < 0) {
+		base = 0;
+	}
+
+	res = cmd_containerTable(handler, stat.size, &count);
+	if (res < 0) {
+		log_error("\nCan't load %s via %s (%d)", argv[2], argv[1], res);
+		phfs_close(handler);
+		return CMD_EXIT_FAILURE;
+	}
+
+	for (i = 0; i < count; i++) {
+		ent = &container_common.ents[container_common.order[i]];
+
+		/* App name without arguments */
+		for (pos = 0; (ent->name[pos] != '\0') && (ent->name[pos] != ';'); pos++) {
+		}
+		hal_memcpy(name, ent->name, pos);
+		name[pos] = '\0';
+
+		res = cmd_containerLoad(handler, base, ent, name);
+		if (res < 0) {
+			log_error("\nCan't load %s from %s to %s (%d)", name, argv[2], ent->imaps, res);
+			phfs_close(handler);
+			return CMD_EXIT_FAILURE;
+		}
+
+		total += ent->size;
+		log_info("\nLoaded %s", name);
+	}
+
+	log_info("\n%s: Loaded %u images, %zu bytes", argv[2], count, total);
+	phfs_close(handler);
+
+	return CMD_EXIT_SUCCESS;
+}
+
+
+static const cmd_t container_cmd __attribute__((section("commands"), used)) = {
+	.name = "container", .run = cmd_container, .info = cmd_containerInfo
+};
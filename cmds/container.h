@@ -0,0 +1,57 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Operating system loader
+ *
+ * Multi-image container layout, shared with tools/mkcontainer
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#ifndef _CONTAINER_H_
+#define _CONTAINER_H_
+
+/* Container layout (little endian): header, entries table, images data.
+ * Includer provides u8, u16 and u32 types */
+
+#define CONTAINER_MAGIC   0x434f4c50u /* "PLOC" */
+#define CONTAINER_VERSION 1
+
+/* Whole entries table is kept in loader memory */
+#ifndef CONTAINER_MAX_ENTRIES
+#define CONTAINER_MAX_ENTRIES 16
+#endif
+
+
+/* clang-format off */
+enum { container_app = 0, container_blob };
+/* clang-format on */
+
+
+typedef struct {
+	u32 magic;
+	u16 version;
+	u16 count; /* Number of entries */
+	u32 size;  /* Size of header and entries table */
+	u32 crc;   /* CRC-32 of the entries table */
+} __attribute__((packed)) container_hdr_t;
+
+
+typedef struct {
+	u32 offs;       /* Image offset from the container start */
+	u32 size;       /* Image size */
+	u32 crc;        /* CRC-32 of the image */
+	u8 type;        /* container_app or container_blob */
+	u8 flags;       /* App flags: flagSyspageExec, flagSyspageNoCopy */
+	u16 reserved;
+	char name[48];  /* App: "name;arg1;arg2...", blob: name */
+	char imaps[32]; /* App: "imap1;imap2...", blob: target map */
+	char dmaps[32]; /* App: "dmap1;dmap2...", blob: unused */
+} __attribute__((packed)) container_ent_t;
+
+
+#endif
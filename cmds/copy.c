@@ -20,49 +20,330 @@
 #include <phfs/phfs.h>
 
 
+/* Transfer buffer size, may be overridden per project */
+#ifndef COPY_BUFF_SIZE
+#define COPY_BUFF_SIZE 0x1000
+#endif
+
+
+#define COPY_MANIFEST_MAGIC 0x43524350 /* "PCRC" */
+
+
+#define COPY_MANIFEST_HDRSZ 12
+
+
+/* Resume manifest, all fields are u32 little-endian:
+ * magic, image size, block size, then crc32 (IEEE 802.3, as zlib crc32) of each block of the image */
+typedef struct {
+	handler_t h;
+	size_t size;
+	size_t blocksz;
+	size_t count;
+	u8 crcs[SIZE_MSG_BUFF];
+} copy_manifest_t;
+
+
+static struct {
+	u8 buff[COPY_BUFF_SIZE];
+	copy_manifest_t manifest;
+} copy_common;
+
+
 static void cmd_copyInfo(void)
 {
 	lib_printf("copies data between devices, usage:\n");
-	lib_printf("%17s%s", "", "copy <src dev> <file/offs size> <dst dev> <file/offs size>");
+	lib_printf("%17s%s", "", "copy [-v] [-b <buff size>] [-r [-m <manifest>]] <src dev> <file/offs size> <dst dev> <file/offs size>");
+}
+
+
+/* Fill buffer with source data, stops on a short read only at the end of data */
+static ssize_t cmd_copyFill(handler_t h, addr_t offs, u8 *buff, size_t len)
+{
+	ssize_t res;
+	size_t rsz = 0;
+
+	while (rsz < len) {
+		res = phfs_read(h, offs + rsz, buff + rsz, len - rsz);
+		if (res < 0) {
+			return res;
+		}
+
+		if (res == 0) {
+			break;
+		}
+		rsz += res;
+	}
+
+	return rsz;
+}
+
+
+static ssize_t cmd_cpbuff2phfs(handler_t h, addr_t offs, const u8 *buff, size_t len)
+{
+	ssize_t res;
+	size_t pos;
+
+	for (pos = 0; pos < len; pos += res) {
+		if ((res = phfs_write(h, offs + pos, buff + pos, len - pos)) <= 0) {
+			log_error("\nCan't write data to address: 0x%x", offs + pos);
+			return (res < 0) ? res : -EIO;
+		}
+	}
+
+	return len;
 }
 
 
-static ssize_t cmd_cpphfs2phfs(handler_t srcHandler, addr_t srcAddr, size_t srcSz, handler_t dstHandler, addr_t dstAddr, size_t dstSz)
+/* Compute crc32 of the len bytes at offs, reading through the given buffer */
+static int cmd_copyCrc(handler_t h, addr_t offs, size_t len, u8 *buff, size_t buffsz, u32 *crc)
 {
 	ssize_t res;
-	u8 buff[SIZE_MSG_BUFF];
-	size_t chunk, rsz = 0, wsz = 0;
+	size_t rsz = 0;
+
+	*crc = 0xffffffff;
+	while (rsz < len) {
+		res = cmd_copyFill(h, offs + rsz, buff, min(buffsz, len - rsz));
+		if (res <= 0) {
+			log_error("\nCan't read back data from address: 0x%x", offs + rsz);
+			return (res < 0) ? res : -EIO;
+		}
+		*crc = lib_crc32(buff, res, *crc);
+		rsz += res;
+	}
+	*crc = ~*crc;
 
+	return EOK;
+}
+
+
+static int cmd_copyVerify(handler_t h, addr_t offs, size_t sz, size_t buffsz, u32 srcCrc)
+{
+	int res;
+	u32 crc;
+
+	res = phfs_sync(h);
+	if ((res < 0) && (res != -ENOSYS)) {
+		log_error("\nCan't sync destination");
+		return res;
+	}
+
+	res = cmd_copyCrc(h, offs, sz, copy_common.buff, buffsz, &crc);
+	if (res < 0) {
+		return res;
+	}
+
+	if (crc != srcCrc) {
+		log_error("\nVerification failed, crc32 0x%08x, expected 0x%08x", crc, srcCrc);
+		return -EIO;
+	}
+
+	log_info("\nVerified %zu bytes, crc32 0x%08x", sz, crc);
+
+	return EOK;
+}
+
+
+static size_t cmd_copySize(size_t srcSz, size_t dstSz)
+{
 	/* Size is not defined, copy the whole file                 */
 	if (srcSz == 0 && dstSz == 0)
-		srcSz = -1;
+		return -1;
 	/* Size is defined, use smaller one to copy piece of memory */
 	else if (srcSz != 0 && dstSz != 0)
-		srcSz = (srcSz < dstSz) ? srcSz : dstSz;
+		return (srcSz < dstSz) ? srcSz : dstSz;
 	/* One of the size is not defined, use the defined one      */
 	else
-		srcSz = (srcSz > dstSz) ? srcSz : dstSz;
+		return (srcSz > dstSz) ? srcSz : dstSz;
+}
+
+
+static ssize_t cmd_cpphfs2phfs(handler_t srcHandler, addr_t srcAddr, size_t srcSz, handler_t dstHandler, addr_t dstAddr, size_t buffsz, int verify)
+{
+	ssize_t res;
+	size_t chunk, len, rsz = 0, wsz = 0;
+	u32 crc = 0xffffffff;
 
+	/* Whole buffer is filled before programming to pass large writes to the destination */
 	do {
-		chunk = ((srcSz - rsz) > sizeof(buff)) ? sizeof(buff) : (srcSz - rsz);
-		if ((res = phfs_read(srcHandler, srcAddr + rsz, buff, chunk)) < 0) {
+		chunk = ((srcSz - rsz) > buffsz) ? buffsz : (srcSz - rsz);
+		if ((res = cmd_copyFill(srcHandler, srcAddr + rsz, copy_common.buff, chunk)) < 0) {
 			log_error("\nCan't read data");
 			return res;
 		}
-		rsz += res;
+		len = res;
+		rsz += len;
+
+		if (verify != 0) {
+			crc = lib_crc32(copy_common.buff, len, crc);
+		}
+
+		res = cmd_cpbuff2phfs(dstHandler, dstAddr + wsz, copy_common.buff, len);
+		if (res < 0) {
+			return res;
+		}
+		wsz += len;
+	} while ((srcSz - rsz) > 0 && len == chunk && len != 0);
+
+	if (verify != 0) {
+		res = cmd_copyVerify(dstHandler, dstAddr, wsz, buffsz, ~crc);
+		if (res < 0) {
+			return res;
+		}
+	}
 
-		chunk = res;
-		while (chunk) {
-			if ((res = phfs_write(dstHandler, dstAddr + wsz, buff, chunk)) < 0) {
-				log_error("\nCan't write data to address: 0x%x", dstAddr + wsz);
+	return wsz;
+}
+
+
+static u32 cmd_copyLe32(const u8 *buff)
+{
+	return (u32)buff[0] | ((u32)buff[1] << 8) | ((u32)buff[2] << 16) | ((u32)buff[3] << 24);
+}
+
+
+/* Get crc32 of the next block from the manifest, crcs are read in batches */
+static int cmd_copyManifestCrc(copy_manifest_t *m, unsigned int block, u32 *crc)
+{
+	ssize_t res;
+	size_t idx = block % (sizeof(m->crcs) / sizeof(u32));
+
+	if (block >= m->count) {
+		return -EINVAL;
+	}
+
+	if (idx == 0) {
+		res = cmd_copyFill(m->h, COPY_MANIFEST_HDRSZ + block * sizeof(u32), m->crcs, min(sizeof(m->crcs), (m->count - block) * sizeof(u32)));
+		if (res < (ssize_t)sizeof(u32)) {
+			log_error("\nCan't read manifest");
+			return (res < 0) ? res : -EIO;
+		}
+	}
+
+	*crc = cmd_copyLe32(m->crcs + idx * sizeof(u32));
+
+	return EOK;
+}
+
+
+static int cmd_copyManifestOpen(copy_manifest_t *m, const char *alias, const char *file)
+{
+	int res;
+	ssize_t len;
+	u8 hdr[COPY_MANIFEST_HDRSZ];
+
+	res = phfs_open(alias, file, PHFS_OPEN_RDONLY, &m->h);
+	if (res < 0) {
+		log_error("\nCan't open manifest '%s' on %s", file, alias);
+		return res;
+	}
+
+	len = cmd_copyFill(m->h, 0, hdr, sizeof(hdr));
+	m->size = cmd_copyLe32(hdr + 4);
+	m->blocksz = cmd_copyLe32(hdr + 8);
+	if ((len != sizeof(hdr)) || (cmd_copyLe32(hdr) != COPY_MANIFEST_MAGIC) || (m->blocksz == 0)) {
+		log_error("\nInvalid manifest '%s'", file);
+		phfs_close(m->h);
+		return -EINVAL;
+	}
+
+	m->count = (m->size + m->blocksz - 1) / m->blocksz;
+
+	return EOK;
+}
+
+
+/* Copy skipping blocks which already match on destination. Expected block crc comes from
+ * the manifest when given, otherwise the source block is read and checksummed on target */
+static ssize_t cmd_cpphfs2phfsResume(handler_t srcHandler, addr_t srcAddr, size_t sz, handler_t dstHandler, addr_t dstAddr, size_t buffsz, copy_manifest_t *m, int verify)
+{
+	ssize_t res;
+	size_t blocksz, len, pos, wsz, done = 0;
+	unsigned int block, skipped = 0;
+	u32 crc, dstCrc;
+	u8 tmp[SIZE_MSG_BUFF];
+
+	if (m != NULL) {
+		sz = min(sz, m->size);
+		blocksz = m->blocksz;
+	}
+	else {
+		blocksz = buffsz;
+	}
+
+	for (block = 0; done < sz; ++block) {
+		len = min(blocksz, sz - done);
+
+		if (m != NULL) {
+			res = cmd_copyManifestCrc(m, block, &crc);
+			if (res < 0) {
 				return res;
 			}
-			chunk -= res;
-			wsz += res;
+
+			res = cmd_copyCrc(dstHandler, dstAddr + done, len, copy_common.buff, buffsz, &dstCrc);
 		}
-	} while ((srcSz - rsz) > 0 && res > 0);
+		else {
+			res = cmd_copyFill(srcHandler, srcAddr + done, copy_common.buff, len);
+			if (res < 0) {
+				log_error("\nCan't read data");
+				return res;
+			}
+			/* End of source data */
+			if (res == 0) {
+				break;
+			}
+			len = res;
+			crc = ~lib_crc32(copy_common.buff, len, 0xffffffff);
 
-	return wsz;
+			res = cmd_copyCrc(dstHandler, dstAddr + done, len, tmp, sizeof(tmp), &dstCrc);
+		}
+
+		if (res < 0) {
+			return res;
+		}
+
+		if (crc == dstCrc) {
+			done += len;
+			skipped++;
+			continue;
+		}
+
+		for (wsz = 0; wsz < len; wsz += pos) {
+			pos = min(buffsz, len - wsz);
+			if ((m != NULL) && (cmd_copyFill(srcHandler, srcAddr + done + wsz, copy_common.buff, pos) != pos)) {
+				log_error("\nCan't read data");
+				return -EIO;
+			}
+
+			res = cmd_cpbuff2phfs(dstHandler, dstAddr + done + wsz, copy_common.buff, pos);
+			if (res < 0) {
+				return res;
+			}
+		}
+
+		if (verify != 0) {
+			res = phfs_sync(dstHandler);
+			if ((res < 0) && (res != -ENOSYS)) {
+				log_error("\nCan't sync destination");
+				return res;
+			}
+
+			res = cmd_copyCrc(dstHandler, dstAddr + done, len, tmp, sizeof(tmp), &dstCrc);
+			if (res < 0) {
+				return res;
+			}
+
+			if (dstCrc != crc) {
+				log_error("\nVerification failed at address: 0x%x", dstAddr + done);
+				return -EIO;
+			}
+		}
+
+		done += len;
+	}
+
+	log_info("\nSkipped %u of %u blocks", skipped, block);
+
+	return done;
 }
 
 
@@ -122,15 +403,54 @@ static int cmd_copy(int argc, char *argv[])
 	addr_t offs[2];
 	handler_t h[2];
 	const char *file[2];
+	char *endptr;
+	const char *manifest = NULL;
+	int opt, verify = 0, resume = 0;
+	size_t buffsz = sizeof(copy_common.buff);
+
+	unsigned int argvID;
 
-	unsigned int argvID = 1;
+	for (;;) {
+		opt = lib_getopt(argc, argv, "vrm:b:");
+		if (opt < 0) {
+			break;
+		}
+
+		switch (opt) {
+			case 'v':
+				verify = 1;
+				break;
+
+			case 'r':
+				resume = 1;
+				break;
+
+			case 'm':
+				manifest = optarg;
+				resume = 1;
+				break;
+
+			case 'b':
+				buffsz = lib_strtoul(optarg, &endptr, 0);
+				if ((*endptr != '\0') || (buffsz == 0) || (buffsz > sizeof(copy_common.buff))) {
+					log_error("\n%s: Wrong buffer size, max 0x%zx", argv[0], sizeof(copy_common.buff));
+					return CMD_EXIT_FAILURE;
+				}
+				break;
+
+			default:
+				cmd_copyInfo();
+				return CMD_EXIT_FAILURE;
+		}
+	}
 
 	/* Parse all comand's arguments */
-	if (argc < 5) {
+	if ((argc - optind) < 4) {
 		log_error("\n%s: Wrong argument count", argv[0]);
 		return CMD_EXIT_FAILURE;
 	}
 
+	argvID = optind;
 	if (cmd_devParse(&h[0], &offs[0], &sz[0], argc, argv, 0, &argvID, &file[0]) < 0) {
 		return CMD_EXIT_FAILURE;
 	}
@@ -140,10 +460,24 @@ static int cmd_copy(int argc, char *argv[])
 		return CMD_EXIT_FAILURE;
 	}
 
+	if ((manifest != NULL) && (cmd_copyManifestOpen(&copy_common.manifest, argv[optind], manifest) < 0)) {
+		phfs_close(h[0]);
+		phfs_close(h[1]);
+		return CMD_EXIT_FAILURE;
+	}
+
 	/* Copy data between devices */
 	log_info("\nCopying data, please wait...");
-	res = cmd_cpphfs2phfs(h[0], offs[0], sz[0], h[1], offs[1], sz[1]);
+	if (resume != 0) {
+		res = cmd_cpphfs2phfsResume(h[0], offs[0], cmd_copySize(sz[0], sz[1]), h[1], offs[1], buffsz, (manifest != NULL) ? &copy_common.manifest : NULL, verify);
+	}
+	else {
+		res = cmd_cpphfs2phfs(h[0], offs[0], cmd_copySize(sz[0], sz[1]), h[1], offs[1], buffsz, verify);
+	}
 
+	if (manifest != NULL) {
+		phfs_close(copy_common.manifest.h);
+	}
 	phfs_close(h[0]);
 	phfs_close(h[1]);
 
@@ -36,6 +36,7 @@ static int cmd_go(int argc, char *argv[])
 
 	log_info("\nRunning Phoenix-RTOS\n");
 	lib_printf(CONSOLE_NORMAL CONSOLE_CURSOR_SHOW);
+	lib_consoleFlush();
 
 	devs_done();
 	hal_done();
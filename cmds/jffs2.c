@@ -27,6 +27,20 @@
 
 #define MIN_CLEANMARKER_SIZE 12u
 
+/* NAND cleanmarker is stored in OOB without hdr_crc */
+#define NAND_CLEANMARKER_SIZE 8u
+
+/* Block head checked for being erased */
+#define JFFS2_HEAD_SIZE 64u
+
+/* Size of the OOB area read through the NAND meta device */
+#define JFFS2_OOB_SIZE 16u
+
+/* Max number of contiguous dirty blocks erased at once */
+#ifndef JFFS2_ERASE_BATCH
+#define JFFS2_ERASE_BATCH 64u
+#endif
+
 
 struct jffs2_cleanmarker_node {
 	u16 magic;
@@ -36,6 +50,102 @@ struct jffs2_cleanmarker_node {
 };
 
 
+typedef struct {
+	unsigned int major;
+	unsigned int minor;
+	int nand;
+	unsigned long blockSize;
+	struct jffs2_cleanmarker_node cleanmarker;
+	size_t cleanmarkerLen; /* Number of cleanmarker bytes written to flash */
+} jffs2_fmt_t;
+
+
+enum { block_dirty = 0, block_clean, block_bad };
+
+
+static int cmd_jffs2IsErased(const u8 *buff, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		if (buff[i] != 0xffu) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+
+static int cmd_jffs2BlockState(const jffs2_fmt_t *fmt, unsigned long block)
+{
+	u8 head[JFFS2_HEAD_SIZE];
+	u8 oob[JFFS2_OOB_SIZE];
+	const addr_t offs = block * fmt->blockSize;
+	size_t markerLen = fmt->cleanmarkerLen;
+	ssize_t res;
+
+	if (fmt->nand != 0) {
+		/* Bad block marker is kept in the first OOB byte, unreadable OOB means bad block as well */
+		res = devs_read(DEV_NAND_META, fmt->minor, offs, oob, sizeof(oob), 0);
+		if ((res < (ssize_t)sizeof(oob)) || (oob[0] == 0x00u)) {
+			return block_bad;
+		}
+
+		if (hal_memcmp(oob, &fmt->cleanmarker, fmt->cleanmarkerLen) != 0) {
+			return block_dirty;
+		}
+
+		/* Cleanmarker is out of band, whole head has to be erased */
+		markerLen = 0;
+	}
+
+	res = devs_read(fmt->major, fmt->minor, offs, head, sizeof(head), 0);
+	if (res < (ssize_t)sizeof(head)) {
+		return (res < 0) ? (int)res : -EIO;
+	}
+
+	if ((markerLen != 0) && (hal_memcmp(head, &fmt->cleanmarker, markerLen) != 0)) {
+		return block_dirty;
+	}
+
+	return (cmd_jffs2IsErased(head + markerLen, sizeof(head) - markerLen) != 0) ? block_clean : block_dirty;
+}
+
+
+static int cmd_jffs2Format(const jffs2_fmt_t *fmt, unsigned long start, unsigned long count, int erase)
+{
+	unsigned long i;
+	ssize_t res;
+	int err = EOK;
+
+	/* Contiguous dirty blocks are erased at once */
+	if (erase != 0) {
+		res = devs_erase(fmt->major, fmt->minor, start * fmt->blockSize, count * fmt->blockSize, 0);
+		if (res < 0) {
+			log_error("\njffs2: Error erasing blocks %lu-%lu (%d)", start, start + count - 1u, (int)res);
+			return (int)res;
+		}
+	}
+
+	for (i = start; i < start + count; i++) {
+		if (fmt->nand != 0) {
+			res = devs_write(DEV_NAND_META, fmt->minor, i * fmt->blockSize, &fmt->cleanmarker, fmt->cleanmarkerLen);
+		}
+		else {
+			res = devs_write(fmt->major, fmt->minor, i * fmt->blockSize, &fmt->cleanmarker, fmt->cleanmarkerLen);
+		}
+
+		if (res < 0) {
+			log_error("\njffs2: Error writing block %lu (%d)", i, (int)res);
+			err = (int)res;
+		}
+	}
+
+	return err;
+}
+
+
 static void cmd_jffs2Info(void)
 {
 	lib_consolePuts("writes jffs2 cleanmarkers, usage: jffs2 -d <major>.<minor> -c <start block>:<number of blocks>:<block size>:<clean marker size> [-e]");
@@ -50,10 +160,11 @@ static void cmd_jffs2Usage(void)
 
 static int cmd_jffs2(int argc, char *argv[])
 {
-	int major = -1, minor = -1, opt, err, cleanmarkers = 0, erase = 0;
+	int major = -1, minor = -1, opt, err, state, cleanmarkers = 0, erase = 0, res = CMD_EXIT_SUCCESS;
 	unsigned long blockSize = -1, numBlocks = -1, startBlock = -1, cleanmarkerSize = -1, i;
+	unsigned long dirtyStart = 0, dirtyCnt = 0, cleanCnt = 0, badCnt = 0, progress = 0;
 	char *endptr;
-	struct jffs2_cleanmarker_node cleanmarker;
+	jffs2_fmt_t fmt;
 
 	for (;;) {
 		opt = lib_getopt(argc, argv, "c:d:e");
@@ -138,33 +249,70 @@ static int cmd_jffs2(int argc, char *argv[])
 		return CMD_EXIT_FAILURE;
 	}
 
-	cleanmarker.magic = JFFS2_MAGIC_BITMASK;
-	cleanmarker.nodetype = JFFS2_NODETYPE_CLEANMARKER;
-	/* TODO handle NAND memory */
-	cleanmarker.totlen = cleanmarkerSize;
-
-	cleanmarker.hdr_crc = lib_crc32((const u8 *)&cleanmarker, sizeof(struct jffs2_cleanmarker_node) - 4u, 0);
+	fmt.major = major;
+	fmt.minor = minor;
+	fmt.blockSize = blockSize;
+	fmt.cleanmarker.magic = JFFS2_MAGIC_BITMASK;
+	fmt.cleanmarker.nodetype = JFFS2_NODETYPE_CLEANMARKER;
+
+	/* On NAND cleanmarker is written to OOB of the first block page */
+	fmt.nand = ((major == DEV_NAND_DATA) && (devs_check(DEV_NAND_META, minor) == EOK)) ? 1 : 0;
+	if (fmt.nand != 0) {
+		fmt.cleanmarker.totlen = NAND_CLEANMARKER_SIZE;
+		fmt.cleanmarker.hdr_crc = 0xffffffffu;
+		fmt.cleanmarkerLen = NAND_CLEANMARKER_SIZE;
+	}
+	else {
+		fmt.cleanmarker.totlen = cleanmarkerSize;
+		fmt.cleanmarker.hdr_crc = lib_crc32((const u8 *)&fmt.cleanmarker, sizeof(struct jffs2_cleanmarker_node) - 4u, 0);
+		fmt.cleanmarkerLen = sizeof(struct jffs2_cleanmarker_node);
+	}
 
-	lib_printf("\n");
 	for (i = 0; i < numBlocks; i++) {
-		/* FIXME should be: log_info("\rjffs2: block %lu/%lu", i, numBlocks); */
-		lib_printf("\rjffs2: block %lu/%lu", i, numBlocks);
+		state = cmd_jffs2BlockState(&fmt, startBlock + i);
+		if (state < 0) {
+			log_error("\njffs2: Error reading block %lu (%d)", startBlock + i, state);
+			res = CMD_EXIT_FAILURE;
+			state = block_dirty;
+		}
+
+		if (state == block_dirty) {
+			if (dirtyCnt == 0) {
+				dirtyStart = startBlock + i;
+			}
+
+			/* Extend dirty range up to the batch limit */
+			if (++dirtyCnt < JFFS2_ERASE_BATCH) {
+				continue;
+			}
+		}
+		else if (state == block_bad) {
+			badCnt++;
+		}
+		else {
+			cleanCnt++;
+		}
 
-		if (erase != 0) {
-			err = devs_erase(major, minor, (startBlock + i) * blockSize, blockSize, 0);
-			if (err < 0) {
-				log_error("\nError erasing %d\n", err);
+		if (dirtyCnt != 0) {
+			if (cmd_jffs2Format(&fmt, dirtyStart, dirtyCnt, erase) < 0) {
+				res = CMD_EXIT_FAILURE;
 			}
+			dirtyCnt = 0;
 		}
-		err = devs_write(major, minor, (startBlock + i) * blockSize, (const void *)&cleanmarker, sizeof(cleanmarker));
-		if (err < 0) {
-			log_error("\nError writing %d\n", err);
+
+		if (((i + 1u) * 100u) / numBlocks >= progress + 10u) {
+			progress = ((i + 1u) * 100u) / numBlocks;
+			log_info("\rjffs2: block %lu/%lu", i + 1u, numBlocks);
 		}
 	}
 
-	log_info("\njffs2: written cleanmarks");
+	if ((dirtyCnt != 0) && (cmd_jffs2Format(&fmt, dirtyStart, dirtyCnt, erase) < 0)) {
+		res = CMD_EXIT_FAILURE;
+	}
+
+	log_info("\njffs2: written cleanmarks, %lu blocks formatted, %lu already clean, %lu bad", numBlocks - cleanCnt - badCnt, cleanCnt, badCnt);
 
-	return CMD_EXIT_SUCCESS;
+	return res;
 }
 
 
@@ -0,0 +1,117 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Operating system loader
+ *
+ * Set console logging mode
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#include "cmd.h"
+
+#include <hal/hal.h>
+#include <lib/lib.h>
+#include <syspage.h>
+
+
+/* Default size of the log passed to the kernel */
+#ifndef LOG_HANDOFF_SIZE
+#define LOG_HANDOFF_SIZE 0x1000
+#endif
+
+#define LOG_HANDOFF_NAME "plo.log"
+
+
+static const char *const modes[] = { "sync", "buffered", "quiet" };
+
+
+static void cmd_logInfo(void)
+{
+	lib_printf("sets console logging mode, optionally passing log to the kernel, usage: log <sync|buffered|quiet> [<map> [<size>]]");
+}
+
+
+static int cmd_logHandoff(const char *map, size_t size)
+{
+	const mapent_t *entry;
+	syspage_prog_t *prog;
+
+	entry = syspage_entryAdd(map, (addr_t)-1, size, SIZE_PAGE);
+	if (entry == NULL) {
+		log_error("\nCannot allocate memory for %s in %s", LOG_HANDOFF_NAME, map);
+		return -ENOMEM;
+	}
+
+	prog = syspage_progAdd(LOG_HANDOFF_NAME, 0);
+	if (prog == NULL) {
+		log_error("\nCannot add syspage program for %s", LOG_HANDOFF_NAME);
+		return -ENOMEM;
+	}
+
+	prog->imaps = NULL;
+	prog->imapSz = 0;
+	prog->dmaps = NULL;
+	prog->dmapSz = 0;
+	prog->start = entry->start;
+	prog->end = entry->end;
+
+	/* Log is recorded up to the kernel start, unused space stays zeroed */
+	lib_consoleSetLog((char *)entry->start, size);
+
+	return EOK;
+}
+
+
+static int cmd_log(int argc, char *argv[])
+{
+	int mode;
+	char *endptr;
+	size_t size = LOG_HANDOFF_SIZE;
+
+	if (argc == 1) {
+		lib_printf("\nlog: Console mode: %s", modes[lib_consoleGetMode()]);
+		return CMD_EXIT_SUCCESS;
+	}
+	else if (argc > 4) {
+		log_error("\n%s: Wrong argument count", argv[0]);
+		return CMD_EXIT_FAILURE;
+	}
+
+	for (mode = 0; mode < (int)(sizeof(modes) / sizeof(modes[0])); ++mode) {
+		if (hal_strcmp(argv[1], modes[mode]) == 0) {
+			break;
+		}
+	}
+
+	if (mode == (int)(sizeof(modes) / sizeof(modes[0]))) {
+		log_error("\n%s: Wrong mode: %s", argv[0], argv[1]);
+		return CMD_EXIT_FAILURE;
+	}
+
+	if (argc == 4) {
+		size = lib_strtoul(argv[3], &endptr, 0);
+		if ((*endptr != '\0') || (size == 0)) {
+			log_error("\n%s: Wrong size: %s", argv[0], argv[3]);
+			return CMD_EXIT_FAILURE;
+		}
+	}
+
+	if ((argc > 2) && (cmd_logHandoff(argv[2], size) < 0)) {
+		return CMD_EXIT_FAILURE;
+	}
+
+	log_info("\nlog: Setting console mode to %s", modes[mode]);
+	lib_consoleSetMode(mode);
+
+	return CMD_EXIT_SUCCESS;
+}
+
+
+static const cmd_t log_cmd __attribute__((section("commands"), used)) = {
+	.name = "log", .run = cmd_log, .info = cmd_logInfo
+};
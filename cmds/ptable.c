@@ -28,8 +28,28 @@
 #define PTABLE_ENTRY_FORMAT  "%2u %-10s %10u %10u %10u %10u   %-12s\n"
 
 
+/* Partitions are read in chunks, each one exactly once */
+#ifndef PTABLE_CHUNK_PARTS
+#define PTABLE_CHUNK_PARTS 16
+#endif
+
+/* Accepts every table the former ptable_t[1024] read buffer could hold */
+#define PTABLE_MAX_PARTS ((1024 * sizeof(ptable_t) - sizeof(ptable_t) - sizeof(ptable_magic)) / sizeof(ptable_part_t))
+
+
+/* Verified partition, kept for comparison with the following chunks and used once the whole table passes */
+typedef struct {
+	u32 offset;
+	u32 size;
+	u8 name[8];
+	u8 type;
+} ptable_entry_t;
+
+
 static struct {
-	ptable_t ptable[1024];
+	ptable_t hdr;
+	ptable_part_t parts[PTABLE_CHUNK_PARTS];
+	ptable_entry_t entries[PTABLE_MAX_PARTS];
 	size_t memsz;
 	size_t blksz;
 } ptable_common;
@@ -37,14 +57,15 @@ static struct {
 
 static void cmd_ptableInfo(void)
 {
-	lib_printf("print partition table, usage: ptable <dev> [<offset>]");
+	lib_printf("print partition table or register partitions as aliases, usage: ptable [-a] <dev> [<offset>]");
 }
 
 
-static int partPrint(ptable_t *p)
+static void partPrint(unsigned int count)
 {
 	const char *type;
-	unsigned int i = p->count;
+	const ptable_entry_t *entry;
+	unsigned int i = count;
 	unsigned int j = 0;
 
 	lib_printf(
@@ -52,7 +73,7 @@ static int partPrint(ptable_t *p)
 		"#", "Name", "Start", "End", "Blocks", "Size", "Type");
 
 	while (i-- != 0) {
-		ptable_part_t *entry = &p->parts[i];
+		entry = &ptable_common.entries[i];
 		type = ptable_typeName(entry->type);
 		lib_printf(
 				PTABLE_ENTRY_FORMAT,
@@ -60,117 +81,221 @@ static int partPrint(ptable_t *p)
 				entry->size / ptable_common.blksz, entry->size,
 				(type != NULL) ? type : "???");
 	}
+}
+
+
+static int partAliasReg(unsigned int count)
+{
+	unsigned int i;
+	const ptable_entry_t *entry;
+	const char *name;
+	addr_t addr;
+	size_t size;
+
+	for (i = 0; i < count; i++) {
+		entry = &ptable_common.entries[i];
+		name = (const char *)entry->name;
+
+		/* Alias left from the previous run, keep scripts re-runnable */
+		if (phfs_aliasGet(name, &addr, &size) == EOK) {
+			if ((addr != entry->offset) || (size != entry->size)) {
+				log_error("\nAlias %s already registered at 0x%x", name, addr);
+				return -EINVAL;
+			}
+			continue;
+		}
+
+		if (phfs_aliasReg(name, entry->offset, entry->size) < 0) {
+			log_error("\nCan't register alias %s", name);
+			return -EINVAL;
+		}
+		log_info("\nRegistered %s at 0x%x, size 0x%x", name, entry->offset, entry->size);
+	}
 
-	return 0;
+	return EOK;
 }
 
 
-static int partRead(handler_t h, addr_t offs)
+static int partEntryAdd(unsigned int idx, ptable_part_t *part)
 {
-	u32 partCount;
-	size_t ptableSize;
+	unsigned int i;
+	const ptable_entry_t *prev;
+	ptable_entry_t *entry = &ptable_common.entries[idx];
+
+	if (ptable_partCheck(&ptable_common.hdr, part, ptable_common.memsz, ptable_common.blksz) < 0) {
+		return -EINVAL;
+	}
+	ptable_partsToHost(part, 1);
+
+	entry->offset = part->offset;
+	entry->size = part->size;
+	entry->type = part->type;
+	hal_memcpy(entry->name, part->name, sizeof(entry->name));
+
+	/* Range and name checked above, end can't overflow */
+	for (i = 0; i < idx; i++) {
+		prev = &ptable_common.entries[i];
+
+		if ((entry->offset < prev->offset + prev->size) && (prev->offset < entry->offset + entry->size)) {
+			return -EINVAL;
+		}
+
+		if (hal_strcmp((const char *)entry->name, (const char *)prev->name) == 0) {
+			return -EINVAL;
+		}
+	}
+
+	return EOK;
+}
+
 
-	int res = phfs_read(h, offs, &partCount, sizeof(partCount));
-	if (res < 0) {
+/* Reads and verifies the whole partition table in one pass, nothing is used before it completes */
+static int partRead(handler_t h, addr_t offs)
+{
+	ssize_t res;
+	int count;
+	unsigned int first, n, i;
+	size_t size;
+	addr_t pos;
+	u8 magic[sizeof(ptable_magic)];
+
+	res = phfs_read(h, offs, &ptable_common.hdr, sizeof(ptable_common.hdr));
+	if (res != sizeof(ptable_common.hdr)) {
 		log_error("\nCan't read data");
-		return res;
+		return (res < 0) ? res : -EIO;
 	}
 
-	if (partCount == 0) {
+	if (ptable_common.hdr.count == 0) {
 		log_error("\nNo partitions at offset 0x%x", offs);
 		return 0;
 	}
 
-	ptableSize = ptable_size(partCount);
-	if (ptableSize > sizeof(ptable_common.ptable)) {
+	count = ptable_hdrVerify(&ptable_common.hdr, ptable_common.blksz);
+	if ((count < 0) || ((size_t)count > PTABLE_MAX_PARTS)) {
 		log_error("\nIncorrect partition table at offset 0x%x", offs);
 		return -1;
 	}
 
-	res = phfs_read(h, offs, ptable_common.ptable, ptableSize);
-	if (res < 0) {
+	pos = offs + sizeof(ptable_t);
+	for (first = 0; first < (unsigned int)count; first += n) {
+		n = min((unsigned int)count - first, PTABLE_CHUNK_PARTS);
+		size = n * sizeof(ptable_part_t);
+
+		res = phfs_read(h, pos, ptable_common.parts, size);
+		if (res != size) {
+			log_error("\nCan't read data");
+			return (res < 0) ? res : -EIO;
+		}
+		pos += size;
+
+		for (i = 0; i < n; i++) {
+			/* CRC is verified first, in little endian */
+			if (partEntryAdd(first + i, &ptable_common.parts[i]) < 0) {
+				log_error("\nIncorrect partition table at offset 0x%x", offs);
+				return -1;
+			}
+		}
+	}
+
+	res = phfs_read(h, pos, magic, sizeof(magic));
+	if (res != sizeof(magic)) {
 		log_error("\nCan't read data");
-		return res;
+		return (res < 0) ? res : -EIO;
 	}
 
-	res = ptable_deserialize(ptable_common.ptable, ptable_common.memsz, ptable_common.blksz);
-	if (res < 0) {
+	if (ptable_magicVerify(magic) < 0) {
 		log_error("\nIncorrect partition table at offset 0x%x", offs);
-		return res;
+		return -1;
 	}
 
-
-	return (int)partCount;
+	return count;
 }
 
 
 static int cmd_ptable(int argc, char *argv[])
 {
-	int res;
+	int res, opt, aliases = 0;
 	addr_t offs = 0;
 	char *endptr = NULL;
+	const char *dev;
 	handler_t h;
 
 	unsigned int major;
 	unsigned int minor;
 	unsigned int prot;
 
-	if ((argc != 2) && (argc != 3)) {
+	for (;;) {
+		opt = lib_getopt(argc, argv, "a");
+		if (opt < 0) {
+			break;
+		}
+
+		if (opt != 'a') {
+			cmd_ptableInfo();
+			return CMD_EXIT_FAILURE;
+		}
+		aliases = 1;
+	}
+
+	if (((argc - optind) != 1) && ((argc - optind) != 2)) {
 		log_error("\n%s: Wrong argument count", argv[0]);
 		return -EINVAL;
 	}
+	dev = argv[optind];
 
-	if (argc == 3) {
-		offs = lib_strtoul(argv[2], &endptr, 0);
-		if (argv[2] == endptr) {
+	if ((argc - optind) == 2) {
+		offs = lib_strtoul(argv[optind + 1], &endptr, 0);
+		if (argv[optind + 1] == endptr) {
 			log_error("\n%s: Wrong arguments", argv[0]);
 			return -EINVAL;
 		}
 	}
 
-	if (phfs_devGet(argv[1], &major, &minor, &prot) != EOK) {
-		lib_printf("\n%s: Invalid phfs name provided: %s\n", argv[0], argv[1]);
+	if (phfs_devGet(dev, &major, &minor, &prot) != EOK) {
+		lib_printf("\n%s: Invalid phfs name provided: %s\n", argv[0], dev);
 		return CMD_EXIT_FAILURE;
 	}
 
 	if (prot != phfs_prot_raw) {
-		lib_printf("\n%s: Device %s does not use raw protocol\n", argv[0], argv[1]);
+		lib_printf("\n%s: Device %s does not use raw protocol\n", argv[0], dev);
 		return CMD_EXIT_FAILURE;
 	}
 
 	if ((devs_control(major, minor, DEV_CONTROL_GETPROP_TOTALSZ, &ptable_common.memsz) != EOK) ||
 		(devs_control(major, minor, DEV_CONTROL_GETPROP_BLOCKSZ, &ptable_common.blksz) != EOK)) {
-		lib_printf("\n%s: Unable to get %s device properties: %s\n", argv[0], argv[1]);
+		lib_printf("\n%s: Unable to get %s device properties\n", argv[0], dev);
 		return CMD_EXIT_FAILURE;
 	}
 
-	if (argc != 3) {
+	if (endptr == NULL) {
 		/* by default ptable is located in the last sector of raw device */
 		offs = ptable_common.memsz - ptable_common.blksz;
 	}
 
-	lib_printf("\nDevice size: %zu", ptable_common.memsz);
-	lib_printf("\nBlock size:  %zu\n", ptable_common.blksz);
+	if (aliases == 0) {
+		lib_printf("\nDevice size: %zu", ptable_common.memsz);
+		lib_printf("\nBlock size:  %zu\n", ptable_common.blksz);
+	}
 
-	if (phfs_open(argv[1], NULL, PHFS_OPEN_RAWONLY, &h) < 0) {
-		lib_printf("\n%s: Invalid phfs name provided: %s\n", argv[0], argv[1]);
+	if (phfs_open(dev, NULL, PHFS_OPEN_RAWONLY, &h) < 0) {
+		lib_printf("\n%s: Invalid phfs name provided: %s\n", argv[0], dev);
 		return CMD_EXIT_FAILURE;
 	}
 
 	res = partRead(h, offs);
-
 	(void)phfs_close(h);
-
 	if (res <= 0) {
 		log_error("\n%s: Missing partition table at offset %zu", argv[0], offs);
 		return CMD_EXIT_FAILURE;
 	}
 
-	if (res > 0) {
-		partPrint(ptable_common.ptable);
-		lib_printf("\nPartition table at offset: %zu\n", offs);
+	if (aliases != 0) {
+		return (partAliasReg(res) < 0) ? CMD_EXIT_FAILURE : CMD_EXIT_SUCCESS;
 	}
 
+	partPrint(res);
+	lib_printf("\nPartition table at offset: %zu\n", offs);
+
 	return CMD_EXIT_SUCCESS;
 }
 
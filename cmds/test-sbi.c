@@ -0,0 +1,98 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Operating system loader
+ *
+ * Test SBI trap emulation paths (riscv64)
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#include <hal/hal.h>
+#include <lib/lib.h>
+
+#include "cmd.h"
+
+
+/* Reserved major opcode (not rdtime), traps to SBI and is redirected back as illegal instruction */
+#define TEST_SBI_ILLEGAL_INSN 0x0000006b
+
+#define TEST_SBI_A0 0x0123456789abcdefuLL
+#define TEST_SBI_A1 0xfedcba9876543210uLL
+#define TEST_SBI_A2 0x5a5a5a5aa5a5a5a5uLL
+
+
+static void cmd_testSbiInfo(void)
+{
+	lib_printf("tests SBI rdtime and illegal instruction trap paths, usage: test-sbi");
+}
+
+
+/* Registers used by the SBI trap entry have to survive the redirected trap */
+static int cmd_testSbiIllegal(void)
+{
+	register u64 a0 __asm__("a0") = TEST_SBI_A0;
+	register u64 a1 __asm__("a1") = TEST_SBI_A1;
+	register u64 a2 __asm__("a2") = TEST_SBI_A2;
+	unsigned int cnt;
+
+	(void)hal_exceptionsIllegalSkip(1);
+	/* clang-format off */
+	__asm__ volatile (".4byte %3" : "+r"(a0), "+r"(a1), "+r"(a2) : "i"(TEST_SBI_ILLEGAL_INSN) : "memory");
+	/* clang-format on */
+	cnt = hal_exceptionsIllegalSkip(0);
+
+	if (cnt != 1) {
+		log_error("\ntest-sbi: illegal instruction trapped %u times, expected 1", cnt);
+		return -1;
+	}
+
+	if ((a0 != TEST_SBI_A0) || (a1 != TEST_SBI_A1) || (a2 != TEST_SBI_A2)) {
+		log_error("\ntest-sbi: registers corrupted by illegal instruction trap");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static int cmd_testSbiRdtime(void)
+{
+	u64 t0, t1;
+
+	t0 = hal_cpuGetCycles();
+	t1 = hal_cpuGetCycles();
+
+	if (t1 < t0) {
+		log_error("\ntest-sbi: rdtime went backwards");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static int cmd_testSbi(int argc, char *argv[])
+{
+	if (argc != 1) {
+		log_error("\n%s: Wrong argument count", argv[0]);
+		return CMD_EXIT_FAILURE;
+	}
+
+	if ((cmd_testSbiIllegal() < 0) || (cmd_testSbiRdtime() < 0)) {
+		return CMD_EXIT_FAILURE;
+	}
+
+	lib_printf("\ntest-sbi: OK");
+
+	return CMD_EXIT_SUCCESS;
+}
+
+
+static const cmd_t testsbi_cmd __attribute__((section("commands"), used)) = {
+	.name = "test-sbi", .run = cmd_testSbi, .info = cmd_testSbiInfo
+};
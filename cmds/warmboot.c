@@ -0,0 +1,60 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Operating system loader
+ *
+ * Reuse images preserved in memory over warm reset
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#include "cmd.h"
+
+#include <hal/hal.h>
+#include <lib/lib.h>
+#include <warmboot.h>
+
+
+static void cmd_warmbootInfo(void)
+{
+	lib_printf("reuses container images left in memory after warm reset, usage: warmboot [-e | -c]");
+}
+
+
+static int cmd_warmboot(int argc, char *argv[])
+{
+	if (argc == 1) {
+		warmboot_show();
+		return CMD_EXIT_SUCCESS;
+	}
+
+	if ((argc != 2) || (argv[1][0] != '-') || (argv[1][1] == '\0') || (argv[1][2] != '\0')) {
+		log_error("\n%s: Wrong arguments", argv[0]);
+		return CMD_EXIT_FAILURE;
+	}
+
+	switch (argv[1][1]) {
+		case 'e':
+			warmboot_enable();
+			break;
+
+		case 'c':
+			warmboot_invalidate();
+			break;
+
+		default:
+			log_error("\n%s: Wrong arguments", argv[0]);
+			return CMD_EXIT_FAILURE;
+	}
+
+	return CMD_EXIT_SUCCESS;
+}
+
+
+static const cmd_t warmboot_cmd __attribute__((section("commands"), used)) = {
+	.name = "warmboot", .run = cmd_warmboot, .info = cmd_warmbootInfo
+};
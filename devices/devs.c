@@ -20,8 +20,19 @@
 #define SIZE_MAJOR 9
 #define SIZE_MINOR 16
 
+/* Initialize devices on the first access instead of in devs_init() */
+#ifndef DEVS_LAZY_INIT
+#define DEVS_LAZY_INIT 1
+#endif
+
+/* Device state: not initialized, initialized, in init or init error (negative errno) */
+#define DEVS_STATE_NONE  0
+#define DEVS_STATE_READY 1
+#define DEVS_STATE_BUSY  2
+
 struct {
 	const dev_t *devs[SIZE_MAJOR][SIZE_MINOR];
+	s8 state[SIZE_MAJOR][SIZE_MINOR];
 } devs_common;
 
 
@@ -43,22 +54,76 @@ void devs_register(unsigned int major, unsigned int nb, const dev_t *dev)
 }
 
 
+static const dev_t *devs_get(unsigned int major, unsigned int minor)
+{
+	return ((major < SIZE_MAJOR) && (minor < SIZE_MINOR)) ?
+		devs_common.devs[major][minor] :
+		NULL;
+}
+
+
+int devs_initDevice(unsigned int major, unsigned int minor)
+{
+	const dev_t *dev = devs_get(major, minor);
+	int res;
+
+	if (dev == NULL) {
+		return -ENODEV;
+	}
+
+	switch (devs_common.state[major][minor]) {
+		case DEVS_STATE_NONE:
+			break;
+
+		case DEVS_STATE_READY:
+			return EOK;
+
+		case DEVS_STATE_BUSY:
+			/* Access from own init, e.g. console output */
+			return -EBUSY;
+
+		default:
+			return devs_common.state[major][minor];
+	}
+
+	/* TODO: check in dtb the availability of a device in the current platform */
+	devs_common.state[major][minor] = DEVS_STATE_BUSY;
+	res = (dev->init != NULL) ? dev->init(minor) : EOK;
+	if (res < 0) {
+		/* Init is not retried, error is kept as the device state */
+		devs_common.state[major][minor] = (res >= -127) ? res : -EIO;
+		return devs_common.state[major][minor];
+	}
+
+	devs_common.state[major][minor] = DEVS_STATE_READY;
+
+	return EOK;
+}
+
+
 void devs_init(void)
 {
 	const dev_t *dev;
 	unsigned int major;
 	unsigned int minor;
 
+	/* Let slow devices proceed in the background until their first access */
 	for (major = 0; major < SIZE_MAJOR; ++major) {
 		for (minor = 0; minor < SIZE_MINOR; ++minor) {
 			dev = devs_common.devs[major][minor];
-			if ((dev != NULL) && (dev->init != NULL)) {
-				/* TODO: check in dtb the availability of a device in the current platform */
-				/* TODO: check initialization */
-				dev->init(minor);
+			if ((dev != NULL) && (dev->start != NULL)) {
+				dev->start(minor);
 			}
 		}
 	}
+
+#if !DEVS_LAZY_INIT
+	for (major = 0; major < SIZE_MAJOR; ++major) {
+		for (minor = 0; minor < SIZE_MINOR; ++minor) {
+			(void)devs_initDevice(major, minor);
+		}
+	}
+#endif
 }
 
 
@@ -92,21 +157,19 @@ const dev_t *devs_iterNext(unsigned int *ctx, unsigned int *major, unsigned int
 }
 
 
-static const dev_t *devs_get(unsigned int major, unsigned int minor)
+/* Initializes device on the first access, returns init error or -ENOSYS if device is missing */
+static int devs_ops(unsigned int major, unsigned int minor, const dev_ops_t **ops)
 {
-	return ((major < SIZE_MAJOR) && (minor < SIZE_MINOR)) ?
-		devs_common.devs[major][minor] :
-		NULL;
-}
+	const dev_t *dev = devs_get(major, minor);
 
+	*ops = NULL;
+	if ((dev == NULL) || (dev->ops == NULL)) {
+		return -ENOSYS;
+	}
 
-static const dev_ops_t *devs_ops(unsigned int major, unsigned int minor)
-{
-	const dev_t *dev = devs_get(major, minor);
+	*ops = dev->ops;
 
-	return (dev != NULL) ?
-		dev->ops :
-		NULL;
+	return devs_initDevice(major, minor);
 }
 
 
@@ -122,9 +185,14 @@ int devs_check(unsigned int major, unsigned int minor)
 
 ssize_t devs_read(unsigned int major, unsigned int minor, addr_t offs, void *buff, size_t len, time_t timeout)
 {
-	const dev_ops_t *ops = devs_ops(major, minor);
+	const dev_ops_t *ops;
+	int res = devs_ops(major, minor, &ops);
+
+	if (res < 0) {
+		return res;
+	}
 
-	return ((ops != NULL) && (ops->read != NULL)) ?
+	return (ops->read != NULL) ?
 		ops->read(minor, offs, buff, len, timeout) :
 		-ENOSYS;
 }
@@ -132,9 +200,14 @@ ssize_t devs_read(unsigned int major, unsigned int minor, addr_t offs, void *buf
 
 ssize_t devs_write(unsigned int major, unsigned int minor, addr_t offs, const void *buff, size_t len)
 {
-	const dev_ops_t *ops = devs_ops(major, minor);
+	const dev_ops_t *ops;
+	int res = devs_ops(major, minor, &ops);
 
-	return ((ops != NULL) && (ops->write != NULL)) ?
+	if (res < 0) {
+		return res;
+	}
+
+	return (ops->write != NULL) ?
 		ops->write(minor, offs, buff, len) :
 		-ENOSYS;
 }
@@ -142,9 +215,14 @@ ssize_t devs_write(unsigned int major, unsigned int minor, addr_t offs, const vo
 
 ssize_t devs_erase(unsigned int major, unsigned int minor, addr_t offs, size_t len, unsigned int flags)
 {
-	const dev_ops_t *ops = devs_ops(major, minor);
+	const dev_ops_t *ops;
+	int res = devs_ops(major, minor, &ops);
+
+	if (res < 0) {
+		return res;
+	}
 
-	return ((ops != NULL) && (ops->erase != NULL)) ?
+	return (ops->erase != NULL) ?
 		ops->erase(minor, offs, len, flags) :
 		-ENOSYS;
 }
@@ -152,9 +230,14 @@ ssize_t devs_erase(unsigned int major, unsigned int minor, addr_t offs, size_t l
 
 int devs_sync(unsigned int major, unsigned int minor)
 {
-	const dev_ops_t *ops = devs_ops(major, minor);
+	const dev_ops_t *ops;
+	int res = devs_ops(major, minor, &ops);
 
-	return ((ops != NULL) && (ops->sync != NULL)) ?
+	if (res < 0) {
+		return res;
+	}
+
+	return (ops->sync != NULL) ?
 		ops->sync(minor) :
 		-ENOSYS;
 }
@@ -162,9 +245,14 @@ int devs_sync(unsigned int major, unsigned int minor)
 
 int devs_map(unsigned int major, unsigned int minor, addr_t addr, size_t sz, int mode, addr_t memaddr, size_t memsz, int memmode, addr_t *a)
 {
-	const dev_ops_t *ops = devs_ops(major, minor);
+	const dev_ops_t *ops;
+	int res = devs_ops(major, minor, &ops);
+
+	if (res < 0) {
+		return res;
+	}
 
-	return ((ops != NULL) && (ops->map != NULL)) ?
+	return (ops->map != NULL) ?
 		ops->map(minor, addr, sz, mode, memaddr, memsz, memmode, a) :
 		-ENOSYS;
 }
@@ -172,9 +260,14 @@ int devs_map(unsigned int major, unsigned int minor, addr_t addr, size_t sz, int
 
 int devs_control(unsigned int major, unsigned int minor, int cmd, void *args)
 {
-	const dev_ops_t *ops = devs_ops(major, minor);
+	const dev_ops_t *ops;
+	int res = devs_ops(major, minor, &ops);
+
+	if (res < 0) {
+		return res;
+	}
 
-	return ((ops != NULL) && (ops->control != NULL)) ?
+	return (ops->control != NULL) ?
 		ops->control(minor, cmd, args) :
 		-ENOSYS;
 }
@@ -188,9 +281,11 @@ void devs_done(void)
 	for (major = 0; major < SIZE_MAJOR; ++major) {
 		for (minor = 0; minor < SIZE_MINOR; ++minor) {
 			dev = devs_common.devs[major][minor];
-			if ((dev != NULL) && (dev->done != NULL)) {
+			/* Started devices are released even if they were never accessed */
+			if ((dev != NULL) && (dev->done != NULL) && ((devs_common.state[major][minor] == DEVS_STATE_READY) || (dev->start != NULL))) {
 				dev->done(minor);
 			}
+			devs_common.state[major][minor] = DEVS_STATE_NONE;
 		}
 	}
 }
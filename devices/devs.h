@@ -54,7 +54,8 @@ typedef struct {
 /* Device enclosure */
 typedef struct _dev_t {
 	const char *name;
-	int (*init)(unsigned int minor);
+	int (*start)(unsigned int minor); /* Optional, non-blocking start of lengthy bring-up (e.g. power-up) */
+	int (*init)(unsigned int minor);  /* Called on the first device access */
 	int (*done)(unsigned int minor);
 	const dev_ops_t *ops;
 } dev_t;
@@ -65,10 +66,14 @@ typedef struct _dev_t {
 extern void devs_register(unsigned int major, unsigned int nb, const dev_t *dev);
 
 
-/* Initialize registered devices */
+/* Start registered devices, initialization is deferred to the first access unless DEVS_LAZY_INIT is 0 */
 extern void devs_init(void);
 
 
+/* Initialize device now if it has not been initialized yet, returns the init result */
+extern int devs_initDevice(unsigned int major, unsigned int minor);
+
+
 /* Enumerate all devices */
 const dev_t *devs_iterNext(unsigned int *ctx, unsigned int *major, unsigned int *minor);
 
@@ -31,10 +31,20 @@
 #define BLOCKS_RCACHE (SIZE_RCACHE / SIZE_BLOCK)
 #define BLOCKS_WCACHE (SIZE_WCACHE / SIZE_BLOCK)
 
+/* Max number of blocks in a single extended read */
+#define BLOCKS_LBA_MAX 127
+
+/* Buffers below this address are reachable from real mode */
+#define ADDR_REAL_MAX 0x100000
+
+/* EDD 3.0 major version (64-bit flat buffer address support) */
+#define EDD_VERSION_30 0x30
+
 
 typedef struct {
-	unsigned char dn;  /* Disk number */
-	unsigned char lba; /* Disk LBA support */
+	unsigned char dn;   /* Disk number */
+	unsigned char lba;  /* Disk LBA support */
+	unsigned char flat; /* Disk 64-bit flat buffer address support */
 	/* Disk geometry packet */
 	struct {
 		u16 len;   /* Packet length */
@@ -74,8 +84,8 @@ struct {
 } diskbios_common;
 
 
-/* Checks for disk LBA support */
-static int diskbios_lba(diskbios_t *disk)
+/* Checks for disk LBA support, returns EDD version on success */
+static int diskbios_lba(diskbios_t *disk, unsigned int *ver)
 {
 	int ret;
 
@@ -93,12 +103,13 @@ static int diskbios_lba(diskbios_t *disk)
 		"testb $0x1, %%cl; "
 		"jz 1f; "
 		"0: "
+		"movzbl %%ah, %%ecx; "
 		"xorl %%eax, %%eax; "
 		"1: "
 		"addl $0xc, %%esp; "
-	: "=a" (ret)
+	: "=a" (ret), "=c" (*ver)
 	: "d" (disk->dn)
-	: "ebx", "ecx", "memory", "cc");
+	: "ebx", "memory", "cc");
 
 	return ret;
 }
@@ -170,8 +181,8 @@ static int diskbios_geometry(diskbios_t *disk)
 }
 
 
-/* Performs read/write access to disk */
-static int diskbios_access(diskbios_t *disk, unsigned char mode, unsigned int c, unsigned int h, unsigned int s, unsigned char n, char *buff)
+/* Performs extended (LBA) read/write access to disk, buffer above real mode memory requires flat address support */
+static int diskbios_accessLBA(diskbios_t *disk, unsigned char mode, unsigned long long sec, unsigned char n, char *buff)
 {
 	/* Disk Address Packet */
 	struct {
@@ -181,34 +192,56 @@ static int diskbios_access(diskbios_t *disk, unsigned char mode, unsigned int c,
 		u16 offs; /* Buffer offset */
 		u16 seg;  /* Buffer segment */
 		u64 sec;  /* Sector (LBA) */
+		u64 flat; /* 64-bit flat buffer address (EDD 3.0) */
 	} __attribute__((packed)) dap;
 	int ret;
 
-	if (disk->lba) {
-		/* Initialize DAP */
+	/* Initialize DAP */
+	dap.res = 0;
+	dap.secs = n;
+	dap.sec = sec;
+
+	if ((unsigned int)buff < ADDR_REAL_MAX) {
+		/* Normalized segment:offset, transfer can't wrap around the segment */
+		dap.len = sizeof(dap) - sizeof(dap.flat);
+		dap.offs = (unsigned int)buff & 0xf;
+		dap.seg = (unsigned int)buff >> 4;
+	}
+	else {
 		dap.len = sizeof(dap);
-		dap.res = 0;
-		dap.secs = n;
-		dap.offs = (unsigned int)buff;
-		dap.seg = ((unsigned int)buff & 0xffff0000) >> 4;
-		dap.sec = ((unsigned long long)c * disk->geo.heads + h) * disk->geo.secs + (s - 1);
-		ret = ((unsigned int)&dap & 0xffff0000) >> 4;
+		dap.offs = 0xffff;
+		dap.seg = 0xffff;
+		dap.flat = (unsigned int)buff;
+	}
+	ret = ((unsigned int)&dap & 0xffff0000) >> 4;
 
-		__asm__ volatile(
-			/* Extended read/write sectors */
-			"pushl $0x13; "
-			"pushl %%eax; "
-			"pushl $0x0; "
-			"movw %%di, %%ax; "
-			"addb $0x40, %%ah; "
-			"call _interrupts_bios; "
-			"jc 0f; "
-			"xorl %%eax, %%eax; "
-			"0: "
-			"addl $0xc, %%esp; "
-		: "+a" (ret)
-		: "d" (disk->dn), "S" (&dap), "D" ((unsigned int)mode << 8)
-		: "memory", "cc");
+	__asm__ volatile(
+		/* Extended read/write sectors */
+		"pushl $0x13; "
+		"pushl %%eax; "
+		"pushl $0x0; "
+		"movw %%di, %%ax; "
+		"addb $0x40, %%ah; "
+		"call _interrupts_bios; "
+		"jc 0f; "
+		"xorl %%eax, %%eax; "
+		"0: "
+		"addl $0xc, %%esp; "
+	: "+a" (ret)
+	: "d" (disk->dn), "S" (&dap), "D" ((unsigned int)mode << 8)
+	: "memory", "cc");
+
+	return ret;
+}
+
+
+/* Performs read/write access to disk */
+static int diskbios_access(diskbios_t *disk, unsigned char mode, unsigned int c, unsigned int h, unsigned int s, unsigned char n, char *buff)
+{
+	int ret;
+
+	if (disk->lba) {
+		ret = diskbios_accessLBA(disk, mode, ((unsigned long long)c * disk->geo.heads + h) * disk->geo.secs + (s - 1), n, buff);
 	}
 	else {
 		ret = ((unsigned int)buff & 0xffff0000) >> 4;
@@ -250,12 +283,45 @@ static diskbios_t *diskbios_get(unsigned int minor)
 }
 
 
+/* Reads whole blocks bypassing read cache, returns number of blocks read */
+static int diskbios_readLBA(diskbios_t *disk, unsigned long long sb, unsigned int nb, char *buff)
+{
+	nb = min(nb, BLOCKS_LBA_MAX);
+
+	/* Read directly to the buffer */
+	if (((unsigned int)buff + nb * SIZE_BLOCK <= ADDR_REAL_MAX) || (disk->flat != 0)) {
+		if (diskbios_accessLBA(disk, DISK_READ, sb, nb, buff) == 0) {
+			return nb;
+		}
+
+		if ((unsigned int)buff + nb * SIZE_BLOCK <= ADDR_REAL_MAX) {
+			return -EIO;
+		}
+
+		/* Flat buffer address is not supported after all */
+		disk->flat = 0;
+	}
+
+	/* Bounce through the read cache */
+	nb = min(nb, BLOCKS_RCACHE);
+	diskbios_common.lrdn = -1;
+
+	if (diskbios_accessLBA(disk, DISK_READ, sb, nb, rcache) != 0) {
+		return -EIO;
+	}
+	hal_memcpy(buff, rcache, nb * SIZE_BLOCK);
+
+	return nb;
+}
+
+
 static ssize_t diskbios_read(unsigned int minor, addr_t offs, void *buff, size_t len, time_t timeout)
 {
 	diskbios_t *disk;
 	unsigned long long sb, eb;
 	unsigned int c, h, s, p;
 	size_t size, n = 0;
+	int ret;
 
 	disk = diskbios_get(minor);
 	if (disk == NULL) {
@@ -271,6 +337,19 @@ static ssize_t diskbios_read(unsigned int minor, addr_t offs, void *buff, size_t
 	eb = (offs + len - 1) / SIZE_BLOCK;
 
 	for (; sb <= eb; sb++) {
+		/* Read whole blocks with maximal size extended reads */
+		if ((disk->lba != 0) && ((offs % SIZE_BLOCK) == 0) && ((len - n) >= SIZE_BLOCK)) {
+			ret = diskbios_readLBA(disk, sb, (len - n) / SIZE_BLOCK, (char *)buff + n);
+			if (ret < 0) {
+				return ret;
+			}
+
+			offs += ret * SIZE_BLOCK;
+			n += ret * SIZE_BLOCK;
+			sb += ret - 1;
+			continue;
+		}
+
 		c = (sb / disk->geo.secs) / disk->geo.heads;
 		h = (sb / disk->geo.secs) % disk->geo.heads;
 		s = sb % disk->geo.secs;
@@ -418,6 +497,7 @@ static int diskbios_done(unsigned int minor)
 static int diskbios_init(unsigned int minor)
 {
 	diskbios_t *disk;
+	unsigned int ver;
 
 	if ((disk = diskbios_get(minor)) == NULL) {
 		return -EINVAL;
@@ -431,7 +511,8 @@ static int diskbios_init(unsigned int minor)
 	}
 
 	/* Check disk LBA support */
-	disk->lba = (diskbios_lba(disk) != 0) ? 0 : 1;
+	disk->lba = (diskbios_lba(disk, &ver) != 0) ? 0 : 1;
+	disk->flat = ((disk->lba != 0) && (ver >= EDD_VERSION_30)) ? 1 : 0;
 
 	/* Get disk geometry */
 	if (diskbios_geometry(disk)) {
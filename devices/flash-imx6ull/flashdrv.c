@@ -277,10 +277,54 @@ static ssize_t flashdrv_read(unsigned int minor, addr_t addr, void *data, size_t
 }
 
 
+/* Blank checks read through the sector buffer, it is invalidated by erase anyway */
+static ssize_t flashdrv_feRead(void *arg, addr_t addr, void *data, size_t len)
+{
+	struct nor_device *dev = arg;
+
+	return nor_readData(&dev->qspi, dev->port, addr, data, len, dev->timeout);
+}
+
+
+static int flashdrv_feErase(void *arg, addr_t addr, size_t len)
+{
+	struct nor_device *dev = arg;
+
+	if (len == NOR_BLOCKSZ) {
+		return nor_eraseBlock(&dev->qspi, dev->port, addr, dev->timeout);
+	}
+
+	return nor_eraseSector(&dev->qspi, dev->port, addr, dev->timeout);
+}
+
+
+static int flashdrv_feEraseChip(void *arg)
+{
+	struct nor_device *dev = arg;
+
+	return nor_eraseChip(&dev->qspi, dev->port, dev->timeout);
+}
+
+
+static void flashdrv_feInit(struct nor_device *dev, flasherase_t *fe)
+{
+	fe->dev = dev;
+	fe->sectorSz = dev->nor->sectorSz;
+	fe->blockSz = NOR_BLOCKSZ;
+	fe->buf = dev->sectorBuf;
+	fe->bufSz = sizeof(dev->sectorBuf);
+	fe->read = flashdrv_feRead;
+	fe->isErased = NULL;
+	fe->erase = flashdrv_feErase;
+	fe->eraseChip = flashdrv_feEraseChip;
+}
+
+
 static ssize_t flashdrv_erase(unsigned int minor, addr_t addr, size_t len, unsigned int flags)
 {
 	int res;
 	addr_t end, addr_mask;
+	flasherase_t fe;
 
 	struct nor_device *dev = minorToDevice(minor);
 
@@ -302,11 +346,14 @@ static ssize_t flashdrv_erase(unsigned int minor, addr_t addr, size_t len, unsig
 	dev->sectorPrevAddr = (addr_t)-1;
 	dev->sectorSyncAddr = (addr_t)-1;
 
+	flashdrv_feInit(dev, &fe);
+
 	/* Chip Erase */
 	if (len == (size_t)-1) {
 		len = dev->qspi.slFlashSz[dev->port];
 		log_info("\nErasing all data from flash device ...");
-		res = nor_eraseChip(&dev->qspi, dev->port, dev->timeout);
+
+		res = flasherase_chip(&fe, len);
 		if (res < 0) {
 			return res;
 		}
@@ -322,18 +369,12 @@ static ssize_t flashdrv_erase(unsigned int minor, addr_t addr, size_t len, unsig
 
 	log_info("\nErasing sectors from 0x%x to 0x%x ...", addr, end);
 
-	len = 0;
-	while (addr < end) {
-		res = nor_eraseSector(&dev->qspi, dev->port, addr, dev->timeout);
-		if (res < 0) {
-			return res;
-		}
-		addr += dev->nor->sectorSz;
-		len += dev->nor->sectorSz;
+	res = flasherase_range(&fe, addr, end);
+	if (res < 0) {
+		return res;
 	}
 
-
-	return len;
+	return end - addr;
 }
 
 
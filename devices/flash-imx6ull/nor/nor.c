@@ -175,6 +175,30 @@ int nor_eraseSector(qspi_t *qspi, u8 port, addr_t addr, time_t timeout)
 }
 
 
+int nor_eraseBlock(qspi_t *qspi, u8 port, addr_t addr, time_t timeout)
+{
+	struct xferOp xfer;
+
+	int res = nor_writeEnable(qspi, port, 1, timeout);
+	if (res < EOK) {
+		return res;
+	}
+
+	xfer.op = xfer_opCommand;
+	xfer.port = port;
+	xfer.timeout = timeout;
+	xfer.addr = addr;
+	xfer.seqIdx = LUT_SEQIDX(qspi_eraseBlock);
+
+	res = qspi_xferExec(qspi, &xfer);
+	if (res < EOK) {
+		return res;
+	}
+
+	return nor_waitBusy(qspi, port, timeout);
+}
+
+
 int nor_eraseChip(qspi_t *qspi, u8 port, time_t timeout)
 {
 	struct xferOp xfer;
@@ -20,6 +20,7 @@
 #define NOR_DEFAULT_TIMEOUT 10000
 #define NOR_SECTORSZ_MAX    0x1000
 #define NOR_PAGESZ_MAX      0x100
+#define NOR_BLOCKSZ         0x10000
 
 
 struct nor_device {
@@ -31,7 +32,7 @@ struct nor_device {
 
 	addr_t sectorPrevAddr;
 	addr_t sectorSyncAddr;
-	u8 sectorBuf[NOR_SECTORSZ_MAX];
+	u8 sectorBuf[NOR_SECTORSZ_MAX] __attribute__((aligned(4)));
 };
 
 
@@ -75,6 +76,9 @@ extern int nor_writeEnable(qspi_t *qspi, u8 port, int enable, time_t timeout);
 extern int nor_eraseSector(qspi_t *qspi, u8 port, addr_t addr, time_t timeout);
 
 
+extern int nor_eraseBlock(qspi_t *qspi, u8 port, addr_t addr, time_t timeout);
+
+
 extern int nor_eraseChip(qspi_t *qspi, u8 port, time_t timeout);
 
 
@@ -323,11 +323,66 @@ static ssize_t flashdrv_read(unsigned int minor, addr_t addr, void *data, size_t
 }
 
 
+/* Blank checks read through the sector buffer, it is invalidated by erase anyway */
+static ssize_t flashdrv_feRead(void *arg, addr_t addr, void *data, size_t len)
+{
+	struct nor_device *dev = arg;
+
+	return nor_readData(&dev->fspi, dev->port, addr, data, len, dev->timeout);
+}
+
+
+static int flashdrv_feErase(void *arg, addr_t addr, size_t len)
+{
+	struct nor_device *dev = arg;
+
+	if (len == NOR_BLOCKSZ) {
+		return nor_eraseBlock(&dev->fspi, dev->port, addr, dev->timeout);
+	}
+
+	return nor_eraseSector(&dev->fspi, dev->port, addr, dev->timeout);
+}
+
+
+static int flashdrv_feEraseChip(void *arg)
+{
+	struct nor_device *dev = arg;
+	u32 capFlags = dev->nor->capFlags;
+	int dieCount;
+
+	if ((capFlags & NOR_CAPS_DIE4) != 0) {
+		dieCount = 4;
+	}
+	else if ((capFlags & NOR_CAPS_DIE2) != 0) {
+		dieCount = 2;
+	}
+	else {
+		dieCount = 1;
+	}
+
+	return nor_eraseChipDie(&dev->fspi, dev->port, capFlags, dieCount, dev->fspi.slFlashSz[dev->port] / dieCount, dev->timeout);
+}
+
+
+static void flashdrv_feInit(struct nor_device *dev, flasherase_t *fe)
+{
+	fe->dev = dev;
+	fe->sectorSz = dev->nor->sectorSz;
+	fe->blockSz = NOR_BLOCKSZ;
+	fe->buf = dev->sectorBuf;
+	fe->bufSz = sizeof(dev->sectorBuf);
+	fe->read = flashdrv_feRead;
+	fe->isErased = NULL;
+	fe->erase = flashdrv_feErase;
+	fe->eraseChip = flashdrv_feEraseChip;
+}
+
+
 static ssize_t flashdrv_erase(unsigned int minor, addr_t addr, size_t len, unsigned int flags)
 {
-	int res, dieCount;
-	u32 capFlags;
+	int res;
 	addr_t end, addr_mask;
+	flasherase_t fe;
 
 	struct nor_device *dev = minorToDevice(minor);
 
@@ -349,23 +404,14 @@ static ssize_t flashdrv_erase(unsigned int minor, addr_t addr, size_t len, unsig
 	dev->sectorPrevAddr = (addr_t)-1;
 	dev->sectorSyncAddr = (addr_t)-1;
 
-	capFlags = dev->nor->capFlags;
+	flashdrv_feInit(dev, &fe);
 
 	/* Chip Erase */
 	if (len == (size_t)-1) {
 		len = dev->fspi.slFlashSz[dev->port];
-		if ((capFlags & NOR_CAPS_DIE4) != 0) {
-			dieCount = 4;
-		}
-		else if ((capFlags & NOR_CAPS_DIE2) != 0) {
-			dieCount = 2;
-		}
-		else {
-			dieCount = 1;
-		}
 		lib_printf("\nErasing all data from flash device ...");
 
-		res = nor_eraseChipDie(&dev->fspi, dev->port, capFlags, dieCount, len / dieCount, dev->timeout);
+		res = flasherase_chip(&fe, len);
 		if (res < 0) {
 			return res;
 		}
@@ -381,17 +427,12 @@ static ssize_t flashdrv_erase(unsigned int minor, addr_t addr, size_t len, unsig
 
 	lib_printf("\nErasing sectors from 0x%x to 0x%x ...", addr, end);
 
-	len = 0;
-	while (addr < end) {
-		res = nor_eraseSector(&dev->fspi, dev->port, addr, dev->timeout);
-		if (res < 0) {
-			return res;
-		}
-		addr += dev->nor->sectorSz;
-		len += dev->nor->sectorSz;
+	res = flasherase_range(&fe, addr, end);
+	if (res < 0) {
+		return res;
 	}
 
-	return len;
+	return end - addr;
 }
 
 
@@ -420,7 +461,7 @@ static int flashdrv_done(unsigned int minor)
 
 static int flashdrv_init(unsigned int minor)
 {
-	int port, res;
+	int port, res, ddr;
 	const char *vendor;
 	size_t flashSz[FLEXSPI_PORTS];
 	struct nor_device *dev = minorToDevice(minor);
@@ -463,14 +504,22 @@ static int flashdrv_init(unsigned int minor)
 
 		flexspi_lutUpdateEntries(&dev->fspi, 0, dev->nor->lut, LUT_ENTRIES, LUT_SEQSZ);
 
+		ddr = 0;
+#if NOR_DTR_READ
+		if (dev->nor->readDtr != NULL) {
+			flexspi_lutUpdate(&dev->fspi, fspi_readData * LUT_SEQSZ, dev->nor->readDtr, LUT_SEQSZ);
+			ddr = 1;
+		}
+#endif
+
 		hal_memset(flashSz, 0, sizeof(flashSz));
 		flashSz[port] = dev->nor->totalSz;
 		flexspi_setFlashSize(&dev->fspi, flashSz, FLEXSPI_PORTS);
 
-		flexspi_postinit(&dev->fspi);
+		flexspi_postinit(&dev->fspi, ddr);
 
-		lib_printf("\ndev/flash/nor: Configured %s %s %dMB nor flash(%d.%d)",
-			vendor, dev->nor->name, dev->nor->totalSz >> 20, DEV_STORAGE, minor);
+		lib_printf("\ndev/flash/nor: Configured %s %s %dMB nor flash(%d.%d)%s",
+			vendor, dev->nor->name, dev->nor->totalSz >> 20, DEV_STORAGE, minor, (ddr != 0) ? " DTR" : "");
 
 		return EOK;
 	}
@@ -46,6 +46,12 @@ enum { flexspi_instance1 = 1, /* referred as FLEXSPI or FLEXSPI1 */
 };
 
 
+/* Root clock setting, in DDR mode serial clock is half of the root clock */
+enum { flexspi_clkNormal = 0,
+	flexspi_clkFast,
+	flexspi_clkDdr };
+
+
 typedef struct _flexspi_t {
 	volatile u32 *base;
 	addr_t ahbAddr;
@@ -82,8 +88,8 @@ struct xferOp {
 extern int flexspi_init(flexspi_t *fspi, int instance, u8 slPortMask);
 
 
-/* Post-initialize single FlexSPI module */
-extern int flexspi_postinit(flexspi_t *fspi);
+/* Post-initialize single FlexSPI module, ddr selects clock for DDR read sequence */
+extern int flexspi_postinit(flexspi_t *fspi, int ddr);
 
 
 /* Safely deinit leaving XIP working */
@@ -106,4 +112,12 @@ extern void flexspi_lutUpdateEntries(flexspi_t *fspi, u32 index, const u32 *lutT
 extern ssize_t flexspi_xferExec(flexspi_t *fspi, struct xferOp *xfer);
 
 
+/* Read data through the AHB window using read sequence (LUT index 0) */
+extern ssize_t flexspi_ahbRead(flexspi_t *fspi, u8 port, addr_t addr, void *data, size_t size);
+
+
+/* Drop data buffered by AHB and cached by CPU after the flash content has changed */
+extern void flexspi_ahbInvalidate(flexspi_t *fspi, u8 port, addr_t addr, size_t size);
+
+
 #endif /* _FLEXSPI_H_ */
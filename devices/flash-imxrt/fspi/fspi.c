@@ -140,7 +140,7 @@ __attribute__((section(".noxip"))) int flexspi_init(flexspi_t *fspi, int instanc
 	hal_cleanDCache();
 
 	/* Configure clock for normal read */
-	flexspi_clockConfig(fspi, 0);
+	flexspi_clockConfig(fspi, flexspi_clkNormal);
 
 	/* Release FlexSPI from reset and power SRAM */
 	flexspi_disable(fspi, 0);
@@ -165,14 +165,17 @@ __attribute__((section(".noxip"))) int flexspi_init(flexspi_t *fspi, int instanc
 		*(fspi->base + ahbrxbuf0cr0 + i) = 0;
 	}
 
-#if 1
+#ifdef FLEXSPI_AHBRXBUF_SPLIT
 	/* Set default all AHB buffers (many small buffers) with prefetch enabled */
 	for (i = 0; i < AHBRXBUF_CNT; ++i) {
 		*(fspi->base + ahbrxbuf0cr0 + i) = (1u << 31) | ((i & 7) << 16) | (1 << 6);
 	}
 #else
-	/* Enable single 4k buffer with prefetch enabled (one big buffer) */
-	*(fspi->base + ahbrxbuf0cr0) = (1u << 31) | (4096 / 8);
+	/* Bulk reads are sequential, use the last buffer (serving all masters) as one big prefetch buffer */
+	for (i = 0; i < AHBRXBUF_CNT - 1; ++i) {
+		*(fspi->base + ahbrxbuf0cr0 + i) = (0xfu << 16);
+	}
+	*(fspi->base + ahbrxbuf0cr0 + AHBRXBUF_CNT - 1) = (1u << 31) | (AHBRXBUF_SZ / 8);
 #endif
 
 	for (i = 0; i < 4; ++i) {
@@ -234,10 +237,10 @@ __attribute__((section(".noxip"))) int flexspi_init(flexspi_t *fspi, int instanc
 }
 
 
-__attribute__((section(".noxip"))) int flexspi_postinit(flexspi_t *fspi)
+__attribute__((section(".noxip"))) int flexspi_postinit(flexspi_t *fspi, int ddr)
 {
 	/* Reconfigure clock for fast read */
-	flexspi_clockConfig(fspi, 1);
+	flexspi_clockConfig(fspi, (ddr != 0) ? flexspi_clkDdr : flexspi_clkFast);
 
 	return EOK;
 }
@@ -282,6 +285,32 @@ __attribute__((section(".noxip"))) static addr_t flexspi_getAddressByPort(flexsp
 }
 
 
+ssize_t flexspi_ahbRead(flexspi_t *fspi, u8 port, addr_t addr, void *data, size_t size)
+{
+	if (addr >= fspi->slFlashSz[port]) {
+		return 0;
+	}
+
+	if ((addr + size) > fspi->slFlashSz[port]) {
+		size = fspi->slFlashSz[port] - addr;
+	}
+
+	hal_memcpy(data, (u8 *)fspi->ahbAddr + flexspi_getAddressByPort(fspi, port, addr), size);
+
+	return size;
+}
+
+
+__attribute__((section(".noxip"))) void flexspi_ahbInvalidate(flexspi_t *fspi, u8 port, addr_t addr, size_t size)
+{
+	/* Software reset flushes AHB RX buffers, LUT and configuration registers are preserved */
+	flexspi_swreset(fspi);
+
+	/* Flash window is cacheable, lines are never dirty */
+	hal_invalDCacheAddr((void *)(fspi->ahbAddr + flexspi_getAddressByPort(fspi, port, addr)), size);
+}
+
+
 int flexspi_deinit(flexspi_t *fspi)
 {
 	/* Leaving initialized */
@@ -401,14 +430,9 @@ __attribute__((section(".noxip"))) ssize_t flexspi_xferExec(flexspi_t *fspi, str
 	if (xfer->op == xfer_opRead) {
 		dataSize = xfer->data.read.sz;
 
-		/* For >64k read out the data directly from the AHB buffer (data may be cached) */
+		/* For >64k read out the data directly from the AHB buffer */
 		if (dataSize > 0xffff) {
-			if ((xfer->addr + dataSize) > fspi->slFlashSz[xfer->port]) {
-				dataSize = fspi->slFlashSz[xfer->port] - xfer->addr;
-			}
-
-			hal_memcpy(xfer->data.read.ptr, (u8 *)fspi->ahbAddr + dataAddr, dataSize);
-			return dataSize;
+			return flexspi_ahbRead(fspi, xfer->port, xfer->addr, xfer->data.read.ptr, dataSize);
 		}
 
 		dataSize &= 0xffff;
@@ -28,6 +28,7 @@ enum { mcr0 = 0, mcr1, mcr2, ahbcr, inten, intr, lutkey, lutcr, ahbrxbuf0cr0, ah
 /* clang-format on */
 
 #define AHBRXBUF_CNT 4
+#define AHBRXBUF_SZ  1024
 
 
 __attribute__((section(".noxip"))) static inline addr_t flexspi_ahbAddr(int instance)
@@ -41,12 +42,13 @@ __attribute__((section(".noxip"))) static inline void *flexspi_getBase(int insta
 }
 
 
-__attribute__((section(".noxip"))) static void flexspi_clockConfig(flexspi_t *fspi, u8 fast)
+__attribute__((section(".noxip"))) static void flexspi_clockConfig(flexspi_t *fspi, u8 clk)
 {
+	/* Fast: 261 / (1 + 1) => 130 MHz, Normal: 261 / (3 + 1) => 65 MHz, DDR: 261 / (1 + 1) / 2 => 65 MHz serial clock */
 	_imxrt_ccmControlGate(pctl_clk_flexspi, clk_state_off);
-	_imxrt_ccmSetDiv(clk_div_flexspi, fast ? 1 : 3); /* Fast: 261 / (1 + 1) => 130 MHz, Normal: 261 / (3 + 1) => 65 MHz */
-	_imxrt_ccmSetMux(clk_mux_flexspi, 3);            /* PLL3 PFD0 */
-	_imxrt_ccmInitUsb1Pfd(clk_pfd0, 33);             /* PLL3_PDF0=261.818MHz */
+	_imxrt_ccmSetDiv(clk_div_flexspi, (clk == flexspi_clkNormal) ? 3 : 1);
+	_imxrt_ccmSetMux(clk_mux_flexspi, 3); /* PLL3 PFD0 */
+	_imxrt_ccmInitUsb1Pfd(clk_pfd0, 33);  /* PLL3_PDF0=261.818MHz */
 	_imxrt_ccmControlGate(pctl_clk_flexspi, clk_state_run_wait);
 }
 
@@ -28,6 +28,7 @@ enum { mcr0 = 0, mcr1, mcr2, ahbcr, inten, intr, lutkey, lutcr, ahbrxbuf0cr0, ah
 /* clang-format on */
 
 #define AHBRXBUF_CNT 4
+#define AHBRXBUF_SZ  1024
 
 
 __attribute__((section(".noxip"))) static addr_t flexspi_ahbAddr(int instance)
@@ -50,20 +51,23 @@ __attribute__((section(".noxip"))) static void *flexspi_getBase(int instance)
 }
 
 
-__attribute__((section(".noxip"))) static void flexspi_clockConfig(flexspi_t *fspi, u8 fast)
+__attribute__((section(".noxip"))) static void flexspi_clockConfig(flexspi_t *fspi, u8 clk)
 {
+	/* Fast: 664 / (4 + 1) => 132 MHz, Normal: 664 / (9 + 1) => 66 MHz, DDR: 664 / (3 + 1) / 2 => 83 MHz serial clock */
+	int div = (clk == flexspi_clkFast) ? 4 : ((clk == flexspi_clkDdr) ? 3 : 9);
+
 	if (fspi->instance == flexspi_instance1) {
 		_imxrt_ccmControlGate(pctl_clk_flexspi, clk_state_off);
-		_imxrt_ccmInitUsb1Pfd(clk_pfd0, 13);             /* PLL3_PDF0=664.6MHz */
-		_imxrt_ccmSetDiv(clk_div_flexspi, fast ? 4 : 9); /* Fast: 664 / (4 + 1) => 132 MHz, Normal: 664 / (9 + 1) => 66 MHz */
-		_imxrt_ccmSetMux(clk_mux_flexspi, 3);            /* PLL3 PFD0 */
+		_imxrt_ccmInitUsb1Pfd(clk_pfd0, 13); /* PLL3_PDF0=664.6MHz */
+		_imxrt_ccmSetDiv(clk_div_flexspi, div);
+		_imxrt_ccmSetMux(clk_mux_flexspi, 3); /* PLL3 PFD0 */
 		_imxrt_ccmControlGate(pctl_clk_flexspi, clk_state_run_wait);
 	}
 	else if (fspi->instance == flexspi_instance2) {
 		_imxrt_ccmControlGate(pctl_clk_flexspi2, clk_state_off);
-		_imxrt_ccmInitUsb1Pfd(clk_pfd0, 13);              /* PLL3_PDF0=664.6MHz */
-		_imxrt_ccmSetDiv(clk_div_flexspi2, fast ? 4 : 9); /* Fast: 664 / (4 + 1) => 132 MHz, Normal: 664 / (9 + 1) => 66 MHz */
-		_imxrt_ccmSetMux(clk_mux_flexspi2, 1);            /* PLL3 PFD0 */
+		_imxrt_ccmInitUsb1Pfd(clk_pfd0, 13); /* PLL3_PDF0=664.6MHz */
+		_imxrt_ccmSetDiv(clk_div_flexspi2, div);
+		_imxrt_ccmSetMux(clk_mux_flexspi2, 1); /* PLL3 PFD0 */
 		_imxrt_ccmControlGate(pctl_clk_flexspi2, clk_state_run_wait);
 	}
 }
@@ -31,6 +31,7 @@ enum { mcr0 = 0, mcr1, mcr2, ahbcr, inten, intr, lutkey, lutcr, ahbrxbuf0cr0, ah
 
 
 #define AHBRXBUF_CNT 8
+#define AHBRXBUF_SZ  4096
 
 
 __attribute__((section(".noxip"))) static addr_t flexspi_ahbAddr(int instance)
@@ -53,24 +54,24 @@ __attribute__((section(".noxip"))) static void *flexspi_getBase(int instance)
 }
 
 
-__attribute__((section(".noxip"))) static void flexspi_clockConfig(flexspi_t *fspi, u8 fast)
+__attribute__((section(".noxip"))) static void flexspi_clockConfig(flexspi_t *fspi, u8 clk)
 {
-	int gate, clk, div, mux, mfd, mfn;
+	/* Normal: 528 / (7 + 1) => 66 MHz, Fast: 528 / (3 + 1) => 132 MHz, DDR: 528 / (2 + 1) / 2 => 88 MHz serial clock */
+	int gate, root, mux, mfd, mfn;
+	int div = (clk == flexspi_clkFast) ? 3 : ((clk == flexspi_clkDdr) ? 2 : 7);
 
 	switch (fspi->instance) {
 		case flexspi_instance1:
-			clk = pctl_clk_flexspi1;
+			root = pctl_clk_flexspi1;
 			gate = pctl_lpcg_flexspi1;
-			div = fast ? 3 : 7;                    /* Fast: 528 / (3 + 1) => 132 MHz, Normal: 528 / (7 + 1) => 66 MHz */
 			mux = mux_clkroot_flexspi1_syspll2out; /* Select main clock: SYS_PLL2_CLK = 528 MHz */
 			mfd = 0;
 			mfn = 0;
 			break;
 
 		case flexspi_instance2:
-			clk = pctl_clk_flexspi2;
+			root = pctl_clk_flexspi2;
 			gate = pctl_lpcg_flexspi2;
-			div = fast ? 3 : 7;                    /* Fast: 528 / (3 + 1) => 132 MHz, Normal: 528 / (7 + 1) => 66 MHz */
 			mux = mux_clkroot_flexspi1_syspll2out; /* Select main clock: SYS_PLL2_CLK = 528 MHz */
 			mfd = 0;
 			mfn = 0;
@@ -82,7 +83,7 @@ __attribute__((section(".noxip"))) static void flexspi_clockConfig(flexspi_t *fs
 
 	_imxrt_setDirectLPCG(gate, 0);
 	/* clkmhz = MHZ(mux) / (div + 1) * mfn / (mfd + 1) */
-	_imxrt_setDevClock(clk, div, mux, mfd, mfn, 1);
+	_imxrt_setDevClock(root, div, mux, mfd, mfn, 1);
 	_imxrt_setDirectLPCG(gate, 1);
 }
 
@@ -55,10 +55,10 @@ static const struct nor_info flashInfo[] = {
 	{ FLASH_ID(0x9d, 0x6019), "IS25LP256", 32 * 1024 * 1024, 0x100, 0x1000, NOR_CAPS_GENERIC, lutIssi4Byte, nor_issiInit },
 
 	/* Micron */
-	{ FLASH_ID(0x20, 0xba19), "MT25QL256", 32 * 1024 * 1024, 0x100, 0x1000, NOR_CAPS_GENERIC | NOR_CAPS_EN4B, lutMicronMono, NULL },
-	{ FLASH_ID(0x20, 0xba20), "MT25QL512", 64 * 1024 * 1024, 0x100, 0x1000, NOR_CAPS_GENERIC | NOR_CAPS_EN4B, lutMicronMono, NULL },
-	{ FLASH_ID(0x20, 0xba21), "MT25QL01G", 128 * 1024 * 1024, 0x100, 0x1000, NOR_CAPS_DIE2 | NOR_CAPS_EN4B, lutMicronDie, NULL },
-	{ FLASH_ID(0x20, 0xba22), "MT25QL02G", 256 * 1024 * 1024, 0x100, 0x1000, NOR_CAPS_DIE4 | NOR_CAPS_EN4B, lutMicronDie, NULL },
+	{ FLASH_ID(0x20, 0xba19), "MT25QL256", 32 * 1024 * 1024, 0x100, 0x1000, NOR_CAPS_GENERIC | NOR_CAPS_EN4B, lutMicronMono, NULL, seq_micronReadDataDtr },
+	{ FLASH_ID(0x20, 0xba20), "MT25QL512", 64 * 1024 * 1024, 0x100, 0x1000, NOR_CAPS_GENERIC | NOR_CAPS_EN4B, lutMicronMono, NULL, seq_micronReadDataDtr },
+	{ FLASH_ID(0x20, 0xba21), "MT25QL01G", 128 * 1024 * 1024, 0x100, 0x1000, NOR_CAPS_DIE2 | NOR_CAPS_EN4B, lutMicronDie, NULL, seq_micronReadDataDtr },
+	{ FLASH_ID(0x20, 0xba22), "MT25QL02G", 256 * 1024 * 1024, 0x100, 0x1000, NOR_CAPS_DIE4 | NOR_CAPS_EN4B, lutMicronDie, NULL, seq_micronReadDataDtr },
 
 	/* Macronix (MXIX) */
 	{ FLASH_ID(0xc2, 0x2016), "MX25L3233", 4 * 1024 * 1024, 0x100, 0x1000, NOR_CAPS_GENERIC, lutGeneric3Byte, nor_mxQuadEnable },
@@ -177,7 +177,38 @@ __attribute__((section(".noxip"))) int nor_eraseSector(flexspi_t *fspi, u8 port,
 		return res;
 	}
 
-	return nor_waitBusy(fspi, port, timeout);
+	res = nor_waitBusy(fspi, port, timeout);
+	flexspi_ahbInvalidate(fspi, port, addr, NOR_SECTORSZ_MAX);
+
+	return res;
+}
+
+
+__attribute__((section(".noxip"))) int nor_eraseBlock(flexspi_t *fspi, u8 port, addr_t addr, time_t timeout)
+{
+	struct xferOp xfer;
+
+	int res = nor_writeEnable(fspi, port, 1, timeout);
+	if (res < EOK) {
+		return res;
+	}
+
+	xfer.op = xfer_opCommand;
+	xfer.port = port;
+	xfer.timeout = timeout;
+	xfer.addr = addr;
+	xfer.seqIdx = LUT_SEQIDX(fspi_eraseBlock);
+	xfer.seqNum = LUT_SEQNUM(fspi_eraseBlock);
+
+	res = flexspi_xferExec(fspi, &xfer);
+	if (res < EOK) {
+		return res;
+	}
+
+	res = nor_waitBusy(fspi, port, timeout);
+	flexspi_ahbInvalidate(fspi, port, addr, NOR_BLOCKSZ);
+
+	return res;
 }
 
 
@@ -233,6 +264,8 @@ __attribute__((section(".noxip"))) int nor_eraseChipDie(flexspi_t *fspi, u8 port
 		}
 	}
 
+	flexspi_ahbInvalidate(fspi, port, 0, dieCount * dieSize);
+
 	return res;
 }
 
@@ -261,24 +294,19 @@ __attribute__((section(".noxip"))) int nor_pageProgram(flexspi_t *fspi, u8 port,
 		return res;
 	}
 
-	return nor_waitBusy(fspi, port, timeout);
+	res = nor_waitBusy(fspi, port, timeout);
+	flexspi_ahbInvalidate(fspi, port, dstAddr, pageSz);
+
+	return res;
 }
 
 
 ssize_t nor_readData(flexspi_t *fspi, u8 port, addr_t addr, void *data, size_t size, time_t timeout)
 {
-	struct xferOp xfer;
+	(void)timeout;
 
-	xfer.op = xfer_opRead;
-	xfer.port = port;
-	xfer.timeout = timeout;
-	xfer.addr = addr;
-	xfer.seqIdx = LUT_SEQIDX(fspi_readData);
-	xfer.seqNum = LUT_SEQNUM(fspi_readData);
-	xfer.data.read.ptr = data;
-	xfer.data.read.sz = size;
-
-	return flexspi_xferExec(fspi, &xfer);
+	/* AHB read uses fspi_readData sequence and prefetches ahead, IP commands are left for status and program */
+	return flexspi_ahbRead(fspi, port, addr, data, size);
 }
 
 
@@ -20,12 +20,18 @@
 #define NOR_DEFAULT_TIMEOUT 10000
 #define NOR_SECTORSZ_MAX    0x1000
 #define NOR_PAGESZ_MAX      0x100
+#define NOR_BLOCKSZ         0x10000
 
 #define NOR_CAPS_GENERIC 0
 #define NOR_CAPS_EN4B    0x100
 #define NOR_CAPS_DIE2    0x1000
 #define NOR_CAPS_DIE4    0x2000
 
+/* Use DTR read sequence on parts providing it (requires DQS pad loopback on the board) */
+#ifndef NOR_DTR_READ
+#define NOR_DTR_READ 0
+#endif
+
 
 struct nor_device {
 	const struct nor_info *nor;
@@ -36,7 +42,7 @@ struct nor_device {
 
 	addr_t sectorPrevAddr;
 	addr_t sectorSyncAddr;
-	u8 sectorBuf[NOR_SECTORSZ_MAX];
+	u8 sectorBuf[NOR_SECTORSZ_MAX] __attribute__((aligned(4)));
 };
 
 
@@ -49,6 +55,7 @@ struct nor_info {
 	u32 capFlags;
 	const u32 **lut;
 	int (*init)(struct nor_device *);
+	const u32 *readDtr; /* DTR read sequence, NULL if not supported */
 };
 
 /* clang-format off */
@@ -76,6 +83,9 @@ extern int nor_writeEnable(flexspi_t *fspi, u8 port, int enable, time_t timeout)
 extern int nor_eraseSector(flexspi_t *fspi, u8 port, addr_t addr, time_t timeout);
 
 
+extern int nor_eraseBlock(flexspi_t *fspi, u8 port, addr_t addr, time_t timeout);
+
+
 extern int nor_eraseChipDie(flexspi_t *fspi, u8 port, u32 capFlags, int dieCount, size_t dieSize, time_t timeout);
 
 
@@ -132,6 +132,14 @@ static const u32 seq_micronReadData[NOR_LUTSEQSZ] = {
 	0
 };
 
+/* Read DTR Quad (4-byte address), DDR dummy operand is given in half cycles (8 cycles) */
+static const u32 seq_micronReadDataDtr[NOR_LUTSEQSZ] = {
+	LUT_SEQ(lutCmd_SDR, lutPad1, FLASH_CMD_4DDRQIOR, lutCmdRADDR_DDR, lutPad4, 0x20),
+	LUT_SEQ(lutCmdDUMMY_DDR, lutPad4, 0x10, lutCmdREAD_DDR, lutPad4, 0x04),
+	LUT_SEQ(lutCmdSTOP, lutPad1, 0, 0, 0, 0),
+	0
+};
+
 
 /* Sector Erase (4-byte address) */
 static const u32 seq_micronEraseSector[NOR_LUTSEQSZ] = {
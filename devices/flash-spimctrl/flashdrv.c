@@ -210,10 +210,52 @@ static ssize_t flashdrv_write(unsigned int minor, addr_t offs, const void *buff,
 }
 
 
+/* Blank checks compare through the memory mapped window */
+static int fdrv_feIsErased(void *arg, addr_t addr, size_t len)
+{
+	return nor_isErased(arg, addr, len);
+}
+
+
+static int fdrv_feErase(void *arg, addr_t addr, size_t len)
+{
+	spimctrl_t *spimctrl = arg;
+
+	if (len == spimctrl->dev.info->sectorSz) {
+		return nor_eraseSector(spimctrl, addr, spimctrl->dev.info->tSE);
+	}
+
+	return nor_eraseBlock(spimctrl, addr, spimctrl->dev.info->tBE);
+}
+
+
+static int fdrv_feEraseChip(void *arg)
+{
+	spimctrl_t *spimctrl = arg;
+
+	return nor_eraseChip(spimctrl, spimctrl->dev.info->tCE);
+}
+
+
+static void fdrv_feInit(spimctrl_t *spimctrl, flasherase_t *fe)
+{
+	fe->dev = spimctrl;
+	fe->sectorSz = spimctrl->dev.info->sectorSz;
+	fe->blockSz = spimctrl->dev.info->blockSz;
+	fe->buf = NULL;
+	fe->bufSz = 0;
+	fe->read = NULL;
+	fe->isErased = fdrv_feIsErased;
+	fe->erase = fdrv_feErase;
+	fe->eraseChip = fdrv_feEraseChip;
+}
+
+
 static ssize_t flashdrv_erase(unsigned int minor, addr_t addr, size_t len, unsigned int flags)
 {
 	ssize_t res;
 	addr_t end;
+	flasherase_t fe;
 	spimctrl_t *spimctrl = fdrv_minorToDevice(minor);
 
 	(void)flags;
@@ -230,38 +272,38 @@ static ssize_t flashdrv_erase(unsigned int minor, addr_t addr, size_t len, unsig
 		return 0;
 	}
 
+	fdrv_feInit(spimctrl, &fe);
+
 	/* Chip Erase */
 
 	if (len == (size_t)-1) {
 		spimctrl->dev.sectorBufAddr = (addr_t)-1;
 		len = spimctrl->dev.info->totalSz;
 		log_info("\nErasing all data from flash device ...");
-		res = nor_eraseChip(spimctrl, spimctrl->dev.info->tCE);
+
+		res = flasherase_chip(&fe, len);
 
 		return (res < 0) ? res : (ssize_t)(len);
 	}
 
 	/* Erase sectors or blocks */
 
-	addr = fdrv_getSectorAddress(&spimctrl->dev, addr);
 	end = fdrv_getSectorAddress(&spimctrl->dev, addr + len + spimctrl->dev.info->sectorSz - 1u);
+	addr = fdrv_getSectorAddress(&spimctrl->dev, addr);
 
 	log_info("\nErasing sectors from 0x%x to 0x%x ...", addr, end);
 
-	len = 0;
-	while (addr < end) {
-		if (addr == spimctrl->dev.sectorBufAddr) {
-			spimctrl->dev.sectorBufAddr = (addr_t)-1;
-		}
-		res = nor_eraseSector(spimctrl, addr, spimctrl->dev.info->tSE);
-		if (res < 0) {
-			return res;
-		}
-		addr += spimctrl->dev.info->sectorSz;
-		len += spimctrl->dev.info->sectorSz;
+	/* Cached sector is being erased */
+	if ((spimctrl->dev.sectorBufAddr >= addr) && (spimctrl->dev.sectorBufAddr < end)) {
+		spimctrl->dev.sectorBufAddr = (addr_t)-1;
+	}
+
+	res = flasherase_range(&fe, addr, end);
+	if (res < 0) {
+		return res;
 	}
 
-	return len;
+	return end - addr;
 }
 
 
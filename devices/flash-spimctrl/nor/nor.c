@@ -38,12 +38,12 @@ enum { write_disable = 0, write_enable };
 
 static const struct nor_cmds nor_macronixCmds = {
 	.rdsr = 0x05u, .wren = 0x06u, .wrdi = 0x04u, .rdear = 0xc8u,
-	.wrear = 0xc5u, .ce = 0x60u, .se = 0x20u, .pp = 0x02u, .read = 0x03u
+	.wrear = 0xc5u, .ce = 0x60u, .se = 0x20u, .be = 0xd8u, .pp = 0x02u, .read = 0x03u
 };
 
 static const struct nor_cmds nor_spansionCmds = {
 	.rdsr = 0x05u, .wren = 0x06u, .wrdi = 0x04u, .rdear = 0x16u,
-	.wrear = 0x17u, .ce = 0x60u, .se = 0xd8u, .pp = 0x02u, .read = 0x03u
+	.wrear = 0x17u, .ce = 0x60u, .se = 0xd8u, .be = 0xd8u, .pp = 0x02u, .read = 0x03u
 };
 
 /* clang-format on */
@@ -56,8 +56,10 @@ static const struct nor_info flashInfo[] = {
 		.totalSz = 32 * 1024 * 1024,
 		.pageSz = 0x100,
 		.sectorSz = 0x1000,
+		.blockSz = 0x10000,
 		.tPP = 2,
 		.tSE = 120,
+		.tBE = 650,
 		.tCE = 150 * 1000,
 		.regions = {
 			{ 8192, 0x1000 },
@@ -71,8 +73,10 @@ static const struct nor_info flashInfo[] = {
 		.totalSz = 16 * 1024 * 1024,
 		.pageSz = 0x100,
 		.sectorSz = 0x10000,
+		.blockSz = 0,
 		.tPP = 1,
 		.tSE = 650,
+		.tBE = 650,
 		.tCE = 165 * 1000,
 		.regions = {
 			{ 32, 0x1000 },
@@ -325,6 +329,74 @@ int nor_eraseSector(spimctrl_t *spimctrl, addr_t addr, time_t timeout)
 }
 
 
+int nor_eraseBlock(spimctrl_t *spimctrl, addr_t addr, time_t timeout)
+{
+	int res;
+	struct xferOp xfer;
+	const u8 cmd[4] = { spimctrl->dev.cmds->be, (addr >> 16) & 0xff, (addr >> 8) & 0xff, addr & 0xff };
+
+	if ((spimctrl->dev.info->blockSz == 0) || ((addr & (spimctrl->dev.info->blockSz - 1u)) != 0)) {
+		return -EINVAL;
+	}
+
+	res = nor_validateEar(spimctrl, addr);
+	if (res < EOK) {
+		return res;
+	}
+
+	res = nor_writeEnable(spimctrl, write_enable);
+	if (res < EOK) {
+		return res;
+	}
+
+	xfer.type = xfer_opWrite;
+	xfer.cmd = cmd;
+	xfer.cmdLen = 4;
+	xfer.txData = NULL;
+	xfer.dataLen = 0;
+
+	res = spimctrl_xfer(spimctrl, &xfer);
+	if (res < EOK) {
+		return res;
+	}
+
+	return nor_waitBusy(spimctrl, timeout);
+}
+
+
+int nor_isErased(spimctrl_t *spimctrl, addr_t addr, size_t len)
+{
+	int res;
+	size_t chunk, i;
+	const u32 *src;
+
+	/* Compare through the memory mapped window, one EAR bank at a time */
+	while (len > 0) {
+		chunk = 0x1000000u - (addr & 0xffffffu);
+		if (chunk > len) {
+			chunk = len;
+		}
+
+		res = nor_validateEar(spimctrl, addr);
+		if (res < EOK) {
+			return res;
+		}
+
+		src = (const u32 *)(spimctrl->maddr + addr);
+		for (i = 0; i < chunk / sizeof(u32); ++i) {
+			if (src[i] != 0xffffffffu) {
+				return 0;
+			}
+		}
+
+		addr += chunk;
+		len -= chunk;
+	}
+
+	return 1;
+}
+
+
 int nor_pageProgram(spimctrl_t *spimctrl, addr_t addr, const void *src, size_t len, time_t timeout)
 {
 	struct xferOp xfer;
@@ -44,6 +44,7 @@ struct nor_cmds {
 	u8 wrear; /* Write bank/extended address register */
 	u8 ce;    /* Chip erase */
 	u8 se;    /* Sector erase */
+	u8 be;    /* Block erase */
 	u8 pp;    /* Page program */
 	u8 read;
 };
@@ -55,9 +56,11 @@ struct nor_info {
 	size_t totalSz;
 	size_t pageSz;
 	size_t sectorSz; /* Max sector size */
+	size_t blockSz;  /* Block erase size, 0 if not larger than sector */
 	/* Times in ms */
 	time_t tPP;
 	time_t tSE;
+	time_t tBE;
 	time_t tCE;
 
 	struct {
@@ -79,6 +82,13 @@ int nor_eraseChip(struct _spimctrl_t *spimctrl, time_t timeout);
 int nor_eraseSector(struct _spimctrl_t *spimctrl, addr_t addr, time_t timeout);
 
 
+int nor_eraseBlock(struct _spimctrl_t *spimctrl, addr_t addr, time_t timeout);
+
+
+/* Returns 1 if range is in erased state, 0 if not, <0 on error */
+int nor_isErased(struct _spimctrl_t *spimctrl, addr_t addr, size_t len);
+
+
 int nor_pageProgram(struct _spimctrl_t *spimctrl, addr_t addr, const void *src, size_t len, time_t timeout);
 
 
@@ -14,11 +14,15 @@
  */
 
 #include <hal/hal.h>
-#include <lib/errno.h>
+#include <lib/lib.h>
 #include <devices/devs.h>
 
 #define FLASH_NO 2
 
+#define FLASH_PAGE_SIZE 0x800u
+#define FLASH_ROW_SIZE  0x100u /* Fast programming row, 32 double words */
+#define FLASH_DW_SIZE   8u
+
 
 static const struct {
 	u32 start;
@@ -29,6 +33,19 @@ static const struct {
 };
 
 
+static struct {
+	/* Physical bank was mass erased, its rows can be fast programmed */
+	u8 erased[FLASH_NO];
+
+	/* Partially written double word, programmed when completed or on sync */
+	int dwBank;
+	addr_t dwOffs;
+	u32 dw[FLASH_DW_SIZE / sizeof(u32)];
+
+	u32 row[FLASH_ROW_SIZE / sizeof(u32)];
+} flashdrv_common = { .dwBank = -1 };
+
+
 static int flashdrv_isValidAddress(unsigned int minor, u32 off, size_t size)
 {
 	size_t fsize = flashParams[minor].end - flashParams[minor].start;
@@ -46,11 +63,50 @@ static int flashdrv_isValidMinor(unsigned int minor)
 }
 
 
+/* Minors follow the current mapping, programming and erase work on physical banks.
+ * Both page erase (BKER) and mass erase (MER1/MER2) take the physical bank */
+static int flashdrv_physBank(unsigned int minor)
+{
+	return (int)minor ^ _stm32_getFlashBank();
+}
+
+
+static addr_t flashdrv_bankAddr(int bank)
+{
+	return flashParams[bank ^ _stm32_getFlashBank()].start;
+}
+
+
+static int flashdrv_dwFlush(void)
+{
+	int res;
+
+	if (flashdrv_common.dwBank < 0) {
+		return EOK;
+	}
+
+	res = _stm32_flashProgram(flashdrv_bankAddr(flashdrv_common.dwBank) + flashdrv_common.dwOffs, flashdrv_common.dw, FLASH_DW_SIZE, 0);
+	flashdrv_common.dwBank = -1;
+
+	return res;
+}
+
+
+static void flashdrv_dwDrop(int bank, addr_t offs, size_t len)
+{
+	/* Pending double word is overwritten or erased */
+	if ((flashdrv_common.dwBank == bank) && (flashdrv_common.dwOffs >= offs) && (flashdrv_common.dwOffs < offs + len)) {
+		flashdrv_common.dwBank = -1;
+	}
+}
+
+
 /* Device interface */
 static ssize_t flashdrv_read(unsigned int minor, addr_t offs, void *buff, size_t len, time_t timeout)
 {
 	char *memptr;
 	ssize_t ret = -EINVAL;
+	addr_t start, end;
 
 	(void)timeout;
 
@@ -59,6 +115,15 @@ static ssize_t flashdrv_read(unsigned int minor, addr_t offs, void *buff, size_t
 
 		hal_memcpy(buff, memptr + offs, len);
 		ret = (ssize_t)len;
+
+		/* Overlay not yet programmed data */
+		if (flashdrv_common.dwBank == flashdrv_physBank(minor)) {
+			start = max(offs, flashdrv_common.dwOffs);
+			end = min(offs + len, flashdrv_common.dwOffs + FLASH_DW_SIZE);
+			if (start < end) {
+				hal_memcpy((u8 *)buff + (start - offs), (u8 *)flashdrv_common.dw + (start - flashdrv_common.dwOffs), end - start);
+			}
+		}
 	}
 
 	return ret;
@@ -67,8 +132,101 @@ static ssize_t flashdrv_read(unsigned int minor, addr_t offs, void *buff, size_t
 
 static ssize_t flashdrv_write(unsigned int minor, addr_t offs, const void *buff, size_t len)
 {
-	/* Not supported. TODO? */
-	return -ENOSYS;
+	const u8 *src = buff;
+	addr_t base, dwOffs;
+	size_t chunk, done = 0;
+	int bank, res = EOK;
+
+	if (flashdrv_isValidMinor(minor) == 0 || flashdrv_isValidAddress(minor, offs, len) == 0) {
+		return -EINVAL;
+	}
+
+	bank = flashdrv_physBank(minor);
+	base = flashParams[minor].start;
+
+	while (done < len) {
+		dwOffs = offs & ~(FLASH_DW_SIZE - 1u);
+
+		if (((offs & (FLASH_DW_SIZE - 1u)) != 0) || ((len - done) < FLASH_DW_SIZE)) {
+			/* Partial double word is kept until completed */
+			if ((flashdrv_common.dwBank != bank) || (flashdrv_common.dwOffs != dwOffs)) {
+				res = flashdrv_dwFlush();
+				if (res < 0) {
+					break;
+				}
+				hal_memcpy(flashdrv_common.dw, (void *)(base + dwOffs), FLASH_DW_SIZE);
+				flashdrv_common.dwBank = bank;
+				flashdrv_common.dwOffs = dwOffs;
+			}
+
+			chunk = min(FLASH_DW_SIZE - (offs - dwOffs), len - done);
+			hal_memcpy((u8 *)flashdrv_common.dw + (offs - dwOffs), src + done, chunk);
+
+			if (((offs + chunk) & (FLASH_DW_SIZE - 1u)) == 0) {
+				res = flashdrv_dwFlush();
+			}
+		}
+		else {
+			/* Whole double words, up to the row boundary */
+			chunk = min((len - done) & ~(FLASH_DW_SIZE - 1u), FLASH_ROW_SIZE - (offs & (FLASH_ROW_SIZE - 1u)));
+			flashdrv_dwDrop(bank, offs, chunk);
+
+			hal_memcpy(flashdrv_common.row, src + done, chunk);
+			res = _stm32_flashProgram(base + offs, flashdrv_common.row, chunk,
+				((flashdrv_common.erased[bank] != 0) && (chunk == FLASH_ROW_SIZE)) ? 1 : 0);
+		}
+
+		if (res < 0) {
+			break;
+		}
+
+		offs += chunk;
+		done += chunk;
+	}
+
+	return (done == 0) ? res : (ssize_t)done;
+}
+
+
+static ssize_t flashdrv_erase(unsigned int minor, addr_t addr, size_t len, unsigned int flags)
+{
+	size_t fsize;
+	addr_t pos, end;
+	int bank, res = EOK;
+
+	(void)flags;
+
+	if (flashdrv_isValidMinor(minor) == 0) {
+		return -EINVAL;
+	}
+
+	bank = flashdrv_physBank(minor);
+	fsize = flashParams[minor].end - flashParams[minor].start;
+
+	if ((len == (size_t)-1) || ((addr == 0) && (len >= fsize))) {
+		/* Mass erase allows fast programming of the bank */
+		addr = 0;
+		end = fsize;
+		res = _stm32_flashErase(bank, -1);
+		flashdrv_common.erased[bank] = (res == EOK) ? 1 : 0;
+	}
+	else {
+		if (flashdrv_isValidAddress(minor, addr, len) == 0) {
+			return -EINVAL;
+		}
+
+		end = (addr + len + FLASH_PAGE_SIZE - 1u) & ~(FLASH_PAGE_SIZE - 1u);
+		addr &= ~(FLASH_PAGE_SIZE - 1u);
+		flashdrv_common.erased[bank] = 0;
+
+		for (pos = addr; (pos < end) && (res == EOK); pos += FLASH_PAGE_SIZE) {
+			res = _stm32_flashErase(bank, pos / FLASH_PAGE_SIZE);
+		}
+	}
+
+	flashdrv_dwDrop(bank, addr, end - addr);
+
+	return (res < 0) ? res : (ssize_t)(end - addr);
 }
 
 
@@ -77,9 +235,7 @@ static int flashdrv_done(unsigned int minor)
 	if (flashdrv_isValidMinor(minor) == 0)
 		return -EINVAL;
 
-	/* Nothing to do */
-
-	return EOK;
+	return flashdrv_dwFlush();
 }
 
 
@@ -88,9 +244,7 @@ static int flashdrv_sync(unsigned int minor)
 	if (flashdrv_isValidMinor(minor) == 0)
 		return -EINVAL;
 
-	/* Nothing to do */
-
-	return EOK;
+	return flashdrv_dwFlush();
 }
 
 
@@ -141,7 +295,7 @@ __attribute__((constructor)) static void flashdrv_reg(void)
 	static const dev_ops_t opsFlashSTM32 = {
 		.read = flashdrv_read,
 		.write = flashdrv_write,
-		.erase = NULL, /* TODO */
+		.erase = flashdrv_erase,
 		.sync = flashdrv_sync,
 		.map = flashdrv_map,
 	};
@@ -17,6 +17,7 @@
 #include "flashcfg.h"
 #include "qspi.h"
 #include <lib/errno.h>
+#include <lib/log.h>
 
 
 /* Generic flash commands */
@@ -93,13 +94,13 @@ static int flashcfg_wren(const flash_info_t *info)
 }
 
 
-static int flashcfg_statusRegGet(const flash_info_t *info, u8 *val)
+static int flashcfg_regGet(u8 opCode, u8 *val)
 {
 	int res;
 	u8 rx[2] = { 0, 0 };
 	u8 tx[2] = { 0, 0 };
 
-	tx[0] = info->cmds[flash_cmd_rdsr1].opCode;
+	tx[0] = opCode;
 
 	qspi_start();
 	res = qspi_polledTransfer(tx, rx, 2, FLASH_TIMEOUT_CMD_MS);
@@ -111,6 +112,12 @@ static int flashcfg_statusRegGet(const flash_info_t *info, u8 *val)
 }
 
 
+static int flashcfg_statusRegGet(const flash_info_t *info, u8 *val)
+{
+	return flashcfg_regGet(info->cmds[flash_cmd_rdsr1].opCode, val);
+}
+
+
 static int flashcfg_wipCheck(const flash_info_t *info, time_t timeout)
 {
 	int res;
@@ -473,13 +480,221 @@ static void flashcfg_winbond(flash_info_t *info)
 }
 
 
+static int flashcfg_regSet(const flash_info_t *info, u8 opCode, const u8 *val, size_t len)
+{
+	int res;
+	u8 tx[3];
+
+	res = flashcfg_wren(info);
+	if (res < 0) {
+		return res;
+	}
+
+	tx[0] = opCode;
+	hal_memcpy(tx + 1, val, len);
+
+	qspi_start();
+	res = qspi_polledTransfer(tx, NULL, len + 1, FLASH_TIMEOUT_CMD_MS);
+	qspi_stop();
+
+	if (res < 0) {
+		return res;
+	}
+
+	return flashcfg_wipCheck(info, FLASH_TIMEOUT_WIP_MS);
+}
+
+
+static int flashcfg_sfdpInit(const flash_info_t *info)
+{
+	int res;
+	u8 sr[2] = { 0, 0 };
+
+	if ((info->cmds[info->readCmd].dataLines != 4) && (info->cmds[info->ppCmd].dataLines != 4)) {
+		return EOK;
+	}
+
+	/* Set Quad Enable bit */
+	switch (info->qer) {
+		case sfdp_qerNone:
+			res = EOK;
+			break;
+
+		case sfdp_qerSr1b6:
+			res = flashcfg_regGet(0x05, &sr[0]);
+			if (res >= 0) {
+				sr[0] |= (1 << 6);
+				res = flashcfg_regSet(info, 0x01, sr, 1);
+			}
+			break;
+
+		case sfdp_qerSr2b7:
+			res = flashcfg_regGet(0x3f, &sr[0]);
+			if (res >= 0) {
+				sr[0] |= (1 << 7);
+				res = flashcfg_regSet(info, 0x3e, sr, 1);
+			}
+			break;
+
+		case sfdp_qerSr2b1Wr31:
+			res = flashcfg_regGet(0x35, &sr[0]);
+			if (res >= 0) {
+				sr[0] |= (1 << 1);
+				res = flashcfg_regSet(info, 0x31, sr, 1);
+			}
+			break;
+
+		default:
+			/* QE is bit 1 of SR2, written with SR1 */
+			res = flashcfg_regGet(0x05, &sr[0]);
+			if ((res >= 0) && (info->qer == sfdp_qerSr2b1Rd35)) {
+				res = flashcfg_regGet(0x35, &sr[1]);
+			}
+			if (res >= 0) {
+				sr[1] |= (1 << 1);
+				res = flashcfg_regSet(info, 0x01, sr, 2);
+			}
+			break;
+	}
+
+	return res;
+}
+
+
+static u8 flashcfg_log2(u64 val)
+{
+	u8 n = 0;
+
+	/* Rounded up */
+	while ((1ull << n) < val) {
+		n++;
+	}
+
+	return n;
+}
+
+
+static void flashcfg_sfdpTimeout(u8 *typical, u8 *max, u32 typ, u32 mx, u8 defTypical, u8 defMax)
+{
+	if (typ == 0) {
+		*typical = defTypical;
+		*max = defMax;
+	}
+	else {
+		*typical = flashcfg_log2(typ);
+		*max = flashcfg_log2((mx + (1u << *typical) - 1u) >> *typical);
+	}
+}
+
+
+static void flashcfg_sfdp(flash_info_t *info, const sfdp_info_t *sfdp)
+{
+	/* Read modes from the fastest, only standard opcodes are recognized by the controller in I/O mode */
+	static const struct {
+		u8 mode;
+		u8 cmd;
+		u8 cmd4;
+		u16 flag4;
+	} reads[] = {
+		{ sfdp_read_1_4_4, flash_cmd_qior, flash_cmd_4qior, sfdp_4b_read_1_4_4 },
+		{ sfdp_read_1_1_4, flash_cmd_qor, flash_cmd_4qor, sfdp_4b_read_1_1_4 },
+		{ sfdp_read_1_2_2, flash_cmd_dior, flash_cmd_4dior, sfdp_4b_read_1_2_2 },
+		{ sfdp_read_1_1_2, flash_cmd_dor, flash_cmd_4dor, sfdp_4b_read_1_1_2 },
+		{ sfdp_read_1_1_1, flash_cmd_fast_read, flash_cmd_4fast_read, sfdp_4b_fastRead },
+	};
+	unsigned int i, addr4;
+	u8 cmd, dummy;
+	int erase = -1;
+	u64 size = sfdp->size;
+
+	info->name = "JEDEC SFDP";
+	info->qer = sfdp->qer;
+	hal_memcpy(info->cmds, flash_defCmds, sizeof(flash_defCmds));
+
+	/* Prefer 4 KB erase to minimize sector buffering, 64 KB otherwise */
+	for (i = 0; i < SFDP_ERASE_TYPES; i++) {
+		if (((sfdp->erase[i].size == 0x1000) && (sfdp->erase[i].opCode == FLASH_CMD_P4E)) ||
+			((sfdp->erase[i].size == 0x10000) && (sfdp->erase[i].opCode == FLASH_CMD_SE) && (erase < 0))) {
+			erase = i;
+		}
+	}
+
+	/* 4-byte addressing requires dedicated opcodes, address mode switching is not supported */
+	addr4 = (size > 0x1000000) ? 1 : 0;
+	if ((addr4 != 0) && (((sfdp->addr4 & sfdp_4b_read) == 0) || ((sfdp->addr4 & sfdp_4b_pp) == 0) ||
+		(erase < 0) || (sfdp->erase[erase].opCode4 == 0))) {
+		log_info("\ndev/flash: No 4-byte address instructions, using first 16 MB");
+		size = 0x1000000;
+		addr4 = 0;
+	}
+
+	info->cfi.chipSize = flashcfg_log2(size);
+	info->cfi.pageSize = flashcfg_log2((sfdp->pageSz != 0) ? sfdp->pageSz : 0x100);
+	info->cfi.fdiDesc = 0x0102;
+
+	info->cfi.regsCount = 1;
+	info->cfi.regs[0].size = (erase < 0) ? 0x100 : (sfdp->erase[erase].size / 0x100);
+	info->cfi.regs[0].count = (size / CFI_SIZE_SECTION(info->cfi.regs[0].size)) - 1u;
+
+	if (erase >= 0) {
+		cmd = (sfdp->erase[erase].size == 0x1000) ? flash_cmd_4p4e : flash_cmd_4p64e;
+		info->cmds[cmd].opCode = sfdp->erase[erase].opCode4;
+	}
+
+	/* Timeouts in CFI format, defaults for JESD216 without timing information */
+	info->cfi.timeoutTypical.byteWrite = 0x6;
+	info->cfi.timeoutMax.byteWrite = 0x2;
+	flashcfg_sfdpTimeout(&info->cfi.timeoutTypical.pageWrite, &info->cfi.timeoutMax.pageWrite, sfdp->ppTyp, sfdp->ppMax, 0x9, 0x2);
+	flashcfg_sfdpTimeout(&info->cfi.timeoutTypical.chipErase, &info->cfi.timeoutMax.chipErase, sfdp->ceTyp, sfdp->ceMax, 0xf, 0x3);
+	if (erase >= 0) {
+		flashcfg_sfdpTimeout(&info->cfi.timeoutTypical.sectorErase, &info->cfi.timeoutMax.sectorErase,
+			sfdp->erase[erase].timeTyp, sfdp->erase[erase].timeMax, 0x8, 0x3);
+	}
+	else {
+		info->cfi.timeoutTypical.sectorErase = 0x8;
+		info->cfi.timeoutMax.sectorErase = 0x3;
+	}
+
+	/* Slow read needs no dummy cycles */
+	info->readCmd = (addr4 != 0) ? flash_cmd_4read : flash_cmd_read;
+	info->ppCmd = (addr4 != 0) ? flash_cmd_4pp : flash_cmd_pp;
+
+	for (i = 0; i < sizeof(reads) / sizeof(reads[0]); i++) {
+		cmd = (addr4 != 0) ? reads[i].cmd4 : reads[i].cmd;
+		dummy = sfdp->read[reads[i].mode].dummyClk;
+
+		if ((sfdp->read[reads[i].mode].opCode != info->cmds[reads[i].cmd].opCode) ||
+			((addr4 != 0) && ((sfdp->addr4 & reads[i].flag4) == 0))) {
+			continue;
+		}
+
+		/* Quad Enable has to be set */
+		if ((info->cmds[cmd].dataLines == 4) && (sfdp->qer > sfdp_qerSr2b1Wr31)) {
+			continue;
+		}
+
+		/* Data received during dummy cycles has to be byte aligned */
+		if (((dummy * info->cmds[cmd].dataLines) % 8) != 0) {
+			continue;
+		}
+
+		info->cmds[reads[i].cmd].dummyCyc = dummy;
+		info->cmds[reads[i].cmd4].dummyCyc = dummy;
+		info->readCmd = cmd;
+		break;
+	}
+
+	info->init = flashcfg_sfdpInit;
+}
+
+
 void flashcfg_jedecIDGet(flash_cmd_t *cmd)
 {
 	hal_memcpy(cmd, &flash_defCmds[flash_cmd_rdid], sizeof(*cmd));
 }
 
 
-int flashcfg_infoResolve(flash_info_t *info)
+int flashcfg_infoResolve(flash_info_t *info, const sfdp_info_t *sfdp)
 {
 	int res = EOK;
 
@@ -498,6 +713,10 @@ int flashcfg_infoResolve(flash_info_t *info)
 	else if ((info->cfi.vendorData[0] == 0xef) && (info->cfi.vendorData[1] == 0x40) && (info->cfi.vendorData[2] == 0x18)) {
 		flashcfg_winbond(info);
 	}
+	/* Unknown part, configure from JEDEC SFDP */
+	else if (sfdp != NULL) {
+		flashcfg_sfdp(info, sfdp);
+	}
 	else {
 		info->name = "Unknown";
 		res = -EINVAL;
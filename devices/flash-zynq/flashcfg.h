@@ -17,6 +17,7 @@
 #define _FLASHCFG_H_
 
 #include <hal/hal.h>
+#include <lib/sfdp.h>
 
 /* Return timeouts in ms */
 #define CFI_TIMEOUT_MAX_PROGRAM(typical, max) (((1u << typical) * (1u << max)) / 1000u)
@@ -113,6 +114,7 @@ typedef struct flash_info {
 	int readCmd; /* Default read command define for specific flash memory */
 	int ppCmd;   /* Default page program command define for specific flash memory */
 	const char *name;
+	u8 qer; /* SFDP quad enable requirements */
 
 	int (*init)(const struct flash_info *info);
 } flash_info_t;
@@ -121,7 +123,8 @@ typedef struct flash_info {
 extern void flashcfg_jedecIDGet(flash_cmd_t *cmd);
 
 
-extern int flashcfg_infoResolve(flash_info_t *info);
+/* Resolves flash configuration based on JEDEC ID, uses SFDP (if not NULL) for unknown parts */
+extern int flashcfg_infoResolve(flash_info_t *info, const sfdp_info_t *sfdp);
 
 
 #endif
@@ -135,6 +135,41 @@ static int flashdrv_cfiRead(flash_cfi_t *cfi)
 }
 
 
+static int flashdrv_sfdpRead(void *arg, u32 addr, void *buff, size_t len)
+{
+	ssize_t res;
+	/* Opcode, 3-byte address and dummy byte, rounded to 4 bytes */
+	const size_t cmdSz = 4 + SFDP_CMD_DUMMY_CLKS / 8;
+	const size_t xferSz = (cmdSz + 0x3) & ~0x3;
+	size_t dataSz = xferSz - cmdSz;
+
+	(void)arg;
+
+	hal_memset(fdrv_common.cmdTx, 0, xferSz);
+	fdrv_common.cmdTx[0] = SFDP_CMD_RDSFDP;
+	fdrv_common.cmdTx[1] = (addr >> 16) & 0xff;
+	fdrv_common.cmdTx[2] = (addr >> 8) & 0xff;
+	fdrv_common.cmdTx[3] = addr & 0xff;
+
+	qspi_start();
+	res = qspi_polledTransfer(fdrv_common.cmdTx, fdrv_common.cmdRx, xferSz, TIMEOUT_CMD_MS);
+	if (res < 0) {
+		qspi_stop();
+		return res;
+	}
+
+	/* Copy data received after dummy bytes */
+	dataSz = (dataSz < len) ? dataSz : len;
+	hal_memcpy(buff, fdrv_common.cmdRx + cmdSz, dataSz);
+	if (len > dataSz) {
+		res = qspi_polledTransfer(NULL, (u8 *)buff + dataSz, len - dataSz, TIMEOUT_CMD_MS);
+	}
+	qspi_stop();
+
+	return res;
+}
+
+
 static int flashdrv_statusRegGet(unsigned int *val)
 {
 	ssize_t res;
@@ -598,6 +633,7 @@ static int flashdrv_map(unsigned int minor, addr_t addr, size_t sz, int mode, ad
 static int flashdrv_init(unsigned int minor)
 {
 	int i, res;
+	sfdp_info_t sfdp;
 	flash_info_t *info = &fdrv_common.info;
 
 	fdrv_common.regID = (u32)-1;
@@ -616,7 +652,9 @@ static int flashdrv_init(unsigned int minor)
 		return res;
 	}
 
-	res = flashcfg_infoResolve(info);
+	/* SFDP configures parts unknown to flashcfg */
+	res = sfdp_parse(&sfdp, flashdrv_sfdpRead, NULL);
+	res = flashcfg_infoResolve(info, (res < 0) ? NULL : &sfdp);
 	if (res < 0) {
 		return res;
 	}
@@ -34,6 +34,8 @@ static struct {
 	nand_t *wnand; /* Last written NAND device */
 	u32 rpage;     /* Last read page */
 	u32 wblock;    /* Last written eraseblock */
+	addr_t wstart; /* Start of data written to cached eraseblock */
+	addr_t wend;   /* End of data written to cached eraseblock */
 	nanddrv_meta_t meta;
 } data_common;
 
@@ -57,6 +59,115 @@ static void data_invalidateNandPage(nand_t *nand)
 }
 
 
+/* Reads cached eraseblock data not overwritten yet */
+static int data_fillCache(nand_t *nand)
+{
+	unsigned int i, npages;
+	addr_t poffs, start, end;
+	int err = 0;
+
+	if ((data_common.wstart == 0u) && (data_common.wend == nand->cfg->erasesz)) {
+		return EOK;
+	}
+
+	/* Page cache is used as a bounce buffer */
+	data_invalidateNandPage(nand);
+
+	npages = nand->cfg->erasesz / nand->cfg->writesz;
+
+	for (i = 0; i < npages; i++) {
+		poffs = i * nand->cfg->writesz;
+		start = poffs;
+		end = poffs + nand->cfg->writesz;
+
+		/* Page fully overwritten */
+		if ((start >= data_common.wstart) && (end <= data_common.wend)) {
+			continue;
+		}
+
+		if (err >= 0) {
+			err = nanddrv_read(nand->dma, (data_common.wblock * npages) + i, nand_page, &data_common.meta);
+		}
+
+		/* Block read failed (block data is lost), fill the rest with erased state */
+		if (err < 0) {
+			hal_memset(nand_page, NAND_ERASED_STATE, nand->cfg->writesz);
+		}
+
+		if (data_common.wstart > start) {
+			hal_memcpy(nand_block + start, nand_page, min(data_common.wstart, end) - start);
+		}
+
+		if (data_common.wend < end) {
+			start = max(data_common.wend, start);
+			hal_memcpy(nand_block + start, nand_page + (start - poffs), end - start);
+		}
+	}
+
+	data_common.wstart = 0;
+	data_common.wend = nand->cfg->erasesz;
+
+	/* Mark it as bad, cached data gets synced at the next good block */
+	if ((err < 0) && (nanddrv_markbad(nand->dma, data_common.wblock * npages) < 0)) {
+		return -EIO;
+	}
+
+	return EOK;
+}
+
+
+/* Extends written area of the cached eraseblock */
+static int data_updateCache(nand_t *nand, addr_t boffs, size_t size)
+{
+	if ((boffs > data_common.wend) || ((boffs + size) < data_common.wstart)) {
+		/* Disjoint areas, complete the block first */
+		return data_fillCache(nand);
+	}
+
+	data_common.wstart = min(data_common.wstart, boffs);
+	data_common.wend = max(data_common.wend, boffs + size);
+
+	return EOK;
+}
+
+
+static void data_setCache(nand_t *nand, u32 block, addr_t boffs)
+{
+	data_common.wnand = nand;
+	data_common.wblock = block;
+	data_common.wstart = boffs;
+	data_common.wend = boffs;
+}
+
+
+/* Erases and programs whole eraseblock directly from the buffer */
+static int data_writeBlock(nand_t *nand, u32 block, const u8 *buff)
+{
+	unsigned int i, npages;
+	int err;
+
+	npages = nand->cfg->erasesz / nand->cfg->writesz;
+
+	err = nanddrv_erase(nand->dma, block * npages);
+	if (err < 0) {
+		return err;
+	}
+
+	/* Page cache is uncached DMA memory, use it as a bounce buffer */
+	data_invalidateNandPage(nand);
+
+	for (i = 0; i < npages; i++) {
+		hal_memcpy(nand_page, buff + (i * nand->cfg->writesz), nand->cfg->writesz);
+		err = nanddrv_write(nand->dma, (block * npages) + i, nand_page, NULL);
+		if (err < 0) {
+			return err;
+		}
+	}
+
+	return EOK;
+}
+
+
 int data_doSync(nand_t *nand)
 {
 	unsigned int i, nblocks, npages;
@@ -64,6 +175,11 @@ int data_doSync(nand_t *nand)
 
 	data_invalidateNandPage(nand);
 	if (nand == data_common.wnand) {
+		err = data_fillCache(nand);
+		if (err < 0) {
+			return err;
+		}
+
 		/* Calculate number of device eraseblocks and pages per eraseblock */
 		nblocks = nand->cfg->size / nand->cfg->erasesz;
 		npages = nand->cfg->erasesz / nand->cfg->writesz;
@@ -158,6 +274,12 @@ static ssize_t data_read(unsigned int minor, addr_t offs, void *buff, size_t len
 
 		if ((nand == data_common.wnand) && (block == data_common.wblock)) {
 			size = min(len - ret, nand->cfg->erasesz - boffs);
+			if ((boffs < data_common.wstart) || ((boffs + size) > data_common.wend)) {
+				err = data_fillCache(nand);
+				if (err < 0) {
+					return err;
+				}
+			}
 			hal_memcpy((u8 *)buff + ret, nand_block + boffs, size);
 			ret += size;
 		}
@@ -202,7 +324,7 @@ static ssize_t data_read(unsigned int minor, addr_t offs, void *buff, size_t len
 static ssize_t data_write(unsigned int minor, addr_t offs, const void *buff, size_t len)
 {
 	nand_t *cnand, *nand = nand_get(minor);
-	unsigned int i, cblock, block, nblocks, npages;
+	unsigned int cblock, block, nblocks, npages;
 	addr_t boffs;
 	size_t size, ret = 0;
 	int err = 0;
@@ -254,40 +376,32 @@ static ssize_t data_write(unsigned int minor, addr_t offs, const void *buff, siz
 				}
 			}
 
-			/* Read new cached block data in front of the written area */
-			for (i = 0; (i * nand->cfg->writesz) < boffs; i++) {
-				err = nanddrv_read(nand->dma, (block * npages) + i, nand_block + (i * nand->cfg->writesz), &data_common.meta);
+			/* Whole eraseblock written, program it directly */
+			if ((boffs == 0u) && ((len - ret) >= nand->cfg->erasesz)) {
+				err = data_writeBlock(nand, block, (const u8 *)buff + ret);
+				/* Block write failed, mark it as bad and write the data to the next good block */
 				if (err < 0) {
-					break;
-				}
-			}
-
-			if (err >= 0) {
-				/* Read new cached block data behind the written area */
-				for (i = max(i, (boffs + len - ret) / nand->cfg->writesz); i < npages; i++) {
-					err = nanddrv_read(nand->dma, (block * npages) + i, nand_block + (i * nand->cfg->writesz), &data_common.meta);
-					if (err < 0) {
-						break;
+					/* Fatal error, can't recover */
+					if (nanddrv_markbad(nand->dma, block * npages) < 0) {
+						return -EIO;
 					}
+					continue;
 				}
-			}
 
-			/* Block read failed (block data is lost), mark it as bad and find next good block */
-			if (err < 0) {
-				/* Fatal error, can't recover */
-				if (nanddrv_markbad(nand->dma, block * npages) < 0) {
-					return -EIO;
-				}
+				ret += nand->cfg->erasesz;
 				continue;
 			}
 
-			/* Set new cached block */
-			data_common.wnand = nand;
-			data_common.wblock = block;
+			/* Set new cached block, unmodified data is read on sync */
+			data_setCache(nand, block, boffs);
 		}
 
 		/* Copy data to cache */
 		size = min(len - ret, nand->cfg->erasesz - boffs);
+		err = data_updateCache(nand, boffs, size);
+		if (err < 0) {
+			return err;
+		}
 		hal_memcpy(nand_block + boffs, (const u8 *)buff + ret, size);
 		ret += size;
 		boffs = 0;
@@ -300,7 +414,7 @@ static ssize_t data_write(unsigned int minor, addr_t offs, const void *buff, siz
 static ssize_t data_erase(unsigned int minor, addr_t offs, size_t len, unsigned int flags)
 {
 	nand_t *nand = nand_get(minor);
-	size_t boffs, size, i, block, nblocks, npages, page, ret = 0;
+	size_t boffs, size, block, nblocks, npages, page, ret = 0;
 	int err;
 
 	(void)flags;
@@ -344,27 +458,15 @@ static ssize_t data_erase(unsigned int minor, addr_t offs, size_t len, unsigned
 					}
 				}
 
-				/* Read new cached block data behind the written area */
-				for (i = 0; i < npages; i++) {
-					err = nanddrv_read(nand->dma, page + i, nand_block + (i * nand->cfg->writesz), &data_common.meta);
-					if (err < 0) {
-						break;
-					}
-				}
-
-				if (err < 0) {
-					err = nanddrv_markbad(nand->dma, page);
-					if (err < 0) {
-						return -EIO;
-					}
-					continue;
-				}
-
-				data_common.wnand = nand;
-				data_common.wblock = block;
+				/* Set new cached block, unmodified data is read on sync */
+				data_setCache(nand, block, boffs);
 			}
 
 			size = min(len - ret, nand->cfg->erasesz - boffs);
+			err = data_updateCache(nand, boffs, size);
+			if (err < 0) {
+				return err;
+			}
 			hal_memset(nand_block + boffs, NAND_ERASED_STATE, size);
 			ret += size;
 			boffs = 0;
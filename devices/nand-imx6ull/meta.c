@@ -20,7 +20,7 @@
 #include "drv.h"
 #include "data.h"
 
-/* NOTICE: meta device relies on data device for init. */
+/* NOTICE: meta device relies on data device for init, meta_init() initializes it first. */
 
 
 static ssize_t meta_read(unsigned int minor, addr_t offs, void *buff, size_t len, time_t timeout)
@@ -36,14 +36,15 @@ static ssize_t meta_read(unsigned int minor, addr_t offs, void *buff, size_t len
 		return -ENODEV;
 	}
 
-	metasz = (nand->cfg->size / nand->cfg->erasesz) * nand->cfg->oobsz;
-
 	if (((len != 0u) && (buff == NULL)) ||
-		(offs >= metasz) || ((offs % nand->cfg->writesz) != 0u)) {
+		(offs >= nand->cfg->size) || ((offs % nand->cfg->writesz) != 0u)) {
 		return -EINVAL;
 	}
 
-	len = min(len, metasz - offs);
+	/* Metadata of each page is addressed at the page offset */
+	metasz = ((nand->cfg->size - offs) / nand->cfg->writesz) * nand->cfg->oobsz;
+
+	len = min(len, metasz);
 	if (len == 0u) {
 		return 0;
 	}
@@ -83,14 +84,15 @@ static ssize_t meta_write(unsigned int minor, addr_t offs, const void *buff, siz
 		return -ENODEV;
 	}
 
-	metasz = (nand->cfg->size / nand->cfg->erasesz) * nand->cfg->oobsz;
-
 	if (((len != 0u) && (buff == NULL)) ||
-		(offs >= metasz) || ((offs % nand->cfg->writesz) != 0u)) {
+		(offs >= nand->cfg->size) || ((offs % nand->cfg->writesz) != 0u)) {
 		return -EINVAL;
 	}
 
-	len = min(len, metasz - offs);
+	/* Metadata of each page is addressed at the page offset */
+	metasz = ((nand->cfg->size - offs) / nand->cfg->writesz) * nand->cfg->oobsz;
+
+	len = min(len, metasz);
 	if (len == 0u) {
 		return 0;
 	}
@@ -149,10 +151,17 @@ static int meta_done(unsigned int minor)
 static int meta_init(unsigned int minor)
 {
 	nand_t *nand = nand_get(minor);
+	int res;
 
 	if (nand == NULL) {
 		return -ENODEV;
 	}
+
+	/* Data device configures the shared NAND state */
+	res = devs_initDevice(DEV_NAND_DATA, minor);
+	if (res < 0) {
+		return res;
+	}
 	lib_printf("\ndev/nand/meta: Configured %s(%d.%d)", nand->cfg->name, DEV_NAND_META, minor);
 
 	return 0;
@@ -20,7 +20,7 @@
 #include "drv.h"
 #include "data.h"
 
-/* NOTICE: raw device relies on data device for init. */
+/* NOTICE: raw device relies on data device for init, raw_init() initializes it first. */
 
 
 /* Linker symbols */
@@ -143,10 +143,17 @@ static int raw_done(unsigned int minor)
 static int raw_init(unsigned int minor)
 {
 	nand_t *nand = nand_get(minor);
+	int res;
 
 	if (nand == NULL) {
 		return -ENODEV;
 	}
+
+	/* Data device configures the shared NAND state */
+	res = devs_initDevice(DEV_NAND_DATA, minor);
+	if (res < 0) {
+		return res;
+	}
 	lib_printf("\ndev/nand/raw: Configured %s(%d.%d)", nand->cfg->name, DEV_NAND_RAW, minor);
 
 	return 0;
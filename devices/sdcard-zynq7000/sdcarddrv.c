@@ -32,8 +32,19 @@ static struct
 };
 
 
+/* Powers up the card, so that its ramp-up overlaps with other devices bring-up */
+int sdcarddrv_start(unsigned int minor)
+{
+	/* Errors are reported by init */
+	(void)sdcard_initHost(SDCARD_SLOT, sdcard_common.dataBuffer);
+
+	return 0;
+}
+
+
 int sdcarddrv_init(unsigned int minor)
 {
+	/* No-op if host was already started */
 	int ret = sdcard_initHost(SDCARD_SLOT, sdcard_common.dataBuffer);
 	if (ret < 0) {
 		lib_printf(
@@ -248,6 +259,7 @@ __attribute__((constructor)) static void sdcarddrv_reg(void)
 
 	static const dev_t devSdCardZYNQ7K = {
 		.name = "sdcard-zynq7000",
+		.start = sdcarddrv_start,
 		.init = sdcarddrv_init,
 		.done = sdcarddrv_done,
 		.ops = &opsSdCardZYNQ7K,
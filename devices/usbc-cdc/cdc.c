@@ -477,10 +477,15 @@ static int cdc_init(unsigned int minor)
 {
 	int res;
 
-	if (PHFS_ACM_PORTS_NB < 1 || PHFS_ACM_PORTS_NB > 2 || minor != endpt_bulk_acm0) {
+	if (PHFS_ACM_PORTS_NB < 1 || PHFS_ACM_PORTS_NB > 2 || minor > SIZE_USB_ENDPTS) {
 		return -EINVAL;
 	}
 
+	if (minor != endpt_bulk_acm0) {
+		/* Client is shared by all endpoints and brought up through the first port */
+		return devs_initDevice(DEV_USB, endpt_bulk_acm0);
+	}
+
 	res = cdc_initUsbClient();
 	if (res < 0) {
 		return res;
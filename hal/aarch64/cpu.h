@@ -78,6 +78,16 @@ static inline void hal_cpuHalt(void)
 	asm volatile("wfi");
 }
 
+
+/* Cycle counter - generic timer virtual count, frequency calibrated if CNTFRQ is not programmed */
+#define HAL_CPU_CYCLES_FREQ ((u64)sysreg_read(cntfrq_el0))
+
+static inline u64 hal_cpuGetCycles(void)
+{
+	hal_cpuInstrBarrier();
+	return sysreg_read(cntvct_el0);
+}
+
 #endif
 
 #endif
@@ -62,6 +62,35 @@ static inline void hal_cpuHalt(void)
 	__asm__ volatile ("wfi");
 }
 
+
+/* Cycle counter - PMCCNTR */
+#define HAL_CPU_CYCLES_BITS 32
+#define HAL_CPU_CYCLES_INIT
+
+static inline u32 hal_cpuGetCycles(void)
+{
+	u32 val;
+
+	__asm__ volatile ("mrc p15, 0, %0, c9, c13, 0" : "=r"(val));
+
+	return val;
+}
+
+
+static inline void hal_cpuCyclesInit(void)
+{
+	u32 val;
+
+	/* PMCR: enable counters, count every cycle (clear divider) */
+	__asm__ volatile ("mrc p15, 0, %0, c9, c12, 0" : "=r"(val));
+	val = (val | 1u) & ~(1u << 3);
+	__asm__ volatile ("mcr p15, 0, %0, c9, c12, 0" : : "r"(val));
+
+	/* PMCNTENSET: enable cycle counter */
+	__asm__ volatile ("mcr p15, 0, %0, c9, c12, 1" : : "r"(1u << 31));
+	hal_cpuInstrBarrier();
+}
+
 #endif
 
 #endif
@@ -32,6 +32,7 @@ static int timer_isr(unsigned int irq, void *data)
 	if (*(timer_common.base + gpt_sr) & 0x1) {
 		*(timer_common.base + gpt_sr) = 0x1; /* clear status */
 		++timer_common.time;
+		hal_timerCyclesUpdate();
 	}
 	hal_cpuDataSyncBarrier();
 
@@ -42,8 +42,10 @@ static int timer_isr(unsigned int irq, void *data)
 	st = *(timer_common.base + isr);
 
 	/* Interval IRQ */
-	if (st & 0x1)
+	if (st & 0x1) {
 		++timer_common.time;
+		hal_timerCyclesUpdate();
+	}
 
 	/* Clear irq status */
 	*(timer_common.base + isr) = st;
@@ -309,6 +309,19 @@ __attribute__((section(".noxip"))) void hal_cpuReboot(void)
 }
 
 
+void hal_cpuCyclesInit(void)
+{
+	/* DEMCR: enable DWT */
+	*(volatile u32 *)0xe000edfc |= (1 << 24);
+	hal_cpuDataSyncBarrier();
+
+	/* Unlock DWT (LAR) where implemented and enable CYCCNT */
+	*(volatile u32 *)0xe0001fb0 = 0xc5acce55;
+	*(volatile u32 *)0xe0001000 |= 1;
+	hal_cpuDataSyncBarrier();
+}
+
+
 void hal_cpuInit(void)
 {
 	cpu_common.scb = (void *)0xe000ed00;
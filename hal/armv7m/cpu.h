@@ -33,8 +33,14 @@
 
 
 #define hal_cpuHalt() do { __asm__ volatile ("wfi"); } while(0)
+
+/* Cycle counter - DWT CYCCNT */
+#define hal_cpuGetCycles() (*(volatile u32 *)0xe0001004)
 /* clang-format on */
 
+#define HAL_CPU_CYCLES_BITS 32
+#define HAL_CPU_CYCLES_INIT
+
 
 extern void hal_scbSetPriorityGrouping(u32 group);
 
@@ -84,4 +90,7 @@ extern void hal_cpuReboot(void);
 extern void hal_cpuInit(void);
 
 
+extern void hal_cpuCyclesInit(void);
+
+
 #endif
@@ -31,6 +31,7 @@ __attribute__((section(".noxip"))) static int timer_isr(unsigned int irq, void *
 	if (*(timer_common.base + gpt_sr) & 0x1) {
 		*(timer_common.base + gpt_sr) = 0x1; /* clear status */
 		++timer_common.time;
+		hal_timerCyclesUpdate();
 	}
 
 	hal_cpuDataSyncBarrier();
@@ -14,6 +14,7 @@
  */
 
 #include <hal/hal.h>
+#include <lib/errno.h>
 #include "stm32l4.h"
 
 static struct {
@@ -425,6 +426,20 @@ int _stm32_getFlashBank(void)
 }
 
 
+static void _stm32_flashCacheReset(void)
+{
+	u32 acr = *(stm32_common.flash + flash_acr);
+
+	/* Caches can be reset only when disabled */
+	*(stm32_common.flash + flash_acr) = acr & ~((1 << 10) | (1 << 9));
+	hal_cpuDataMemoryBarrier();
+	*(stm32_common.flash + flash_acr) |= (1 << 12) | (1 << 11);
+	*(stm32_common.flash + flash_acr) &= ~((1 << 12) | (1 << 11));
+	*(stm32_common.flash + flash_acr) = acr;
+	hal_cpuDataMemoryBarrier();
+}
+
+
 void _stm32_switchFlashBank(int bank)
 {
 	if (bank == 0) {
@@ -433,6 +448,119 @@ void _stm32_switchFlashBank(int bank)
 	else {
 		*(stm32_common.syscfg + syscfg_memrmp) |= 1 << 8;
 	}
+
+	/* Cached flash content belongs to the previously mapped bank */
+	_stm32_flashCacheReset();
+}
+
+
+/* Flash programming */
+
+
+#define FLASH_SR_ERR   0xc3fau
+#define FLASH_SR_BSY   (1u << 16)
+#define FLASH_CR_PG    (1u << 0)
+#define FLASH_CR_PER   (1u << 1)
+#define FLASH_CR_MER1  (1u << 2)
+#define FLASH_CR_BKER  (1u << 11)
+#define FLASH_CR_MER2  (1u << 15)
+#define FLASH_CR_STRT  (1u << 16)
+#define FLASH_CR_FSTPG (1u << 18)
+#define FLASH_CR_LOCK  (1u << 31)
+
+
+static int _stm32_flashWait(void)
+{
+	u32 sr;
+
+	while ((*(stm32_common.flash + flash_sr) & FLASH_SR_BSY) != 0) {
+	}
+
+	/* Clear EOP and error flags */
+	sr = *(stm32_common.flash + flash_sr);
+	*(stm32_common.flash + flash_sr) = sr & (FLASH_SR_ERR | 1u);
+
+	return ((sr & FLASH_SR_ERR) != 0) ? -EIO : EOK;
+}
+
+
+static int _stm32_flashUnlock(void)
+{
+	int res = _stm32_flashWait();
+
+	if ((*(stm32_common.flash + flash_cr) & FLASH_CR_LOCK) != 0) {
+		*(stm32_common.flash + flash_keyr) = 0x45670123;
+		*(stm32_common.flash + flash_keyr) = 0xcdef89ab;
+	}
+
+	return ((*(stm32_common.flash + flash_cr) & FLASH_CR_LOCK) != 0) ? -EPERM : res;
+}
+
+
+static void _stm32_flashLock(void)
+{
+	*(stm32_common.flash + flash_cr) = FLASH_CR_LOCK;
+}
+
+
+/* BKER and MER1/MER2 select physical banks regardless of SYSCFG_MEMRMP.FB_MODE (RM0351, FLASH_CR).
+ * STM32Cube examples resolve the bank from the address and invert it when FB_MODE is set,
+ * flash-stm32 does the same when it converts the minor (mapped bank) to the physical bank */
+int _stm32_flashErase(int bank, int page)
+{
+	int res = _stm32_flashUnlock();
+
+	if (res == EOK) {
+		if (page < 0) {
+			*(stm32_common.flash + flash_cr) = (bank == 0) ? FLASH_CR_MER1 : FLASH_CR_MER2;
+		}
+		else {
+			*(stm32_common.flash + flash_cr) = FLASH_CR_PER | ((page & 0xff) << 3) | ((bank == 0) ? 0 : FLASH_CR_BKER);
+		}
+		*(stm32_common.flash + flash_cr) |= FLASH_CR_STRT;
+		hal_cpuDataMemoryBarrier();
+
+		res = _stm32_flashWait();
+	}
+
+	_stm32_flashLock();
+	_stm32_flashCacheReset();
+
+	return res;
+}
+
+
+int _stm32_flashProgram(addr_t addr, const u32 *data, size_t len, int fast)
+{
+	volatile u32 *dst = (volatile u32 *)addr;
+	size_t i;
+	int res = _stm32_flashUnlock();
+
+	if (res == EOK) {
+		if (fast != 0) {
+			/* Row has to be written without gaps, interrupts could exceed the allowed time between words */
+			hal_interruptsDisableAll();
+			*(stm32_common.flash + flash_cr) = FLASH_CR_FSTPG;
+			for (i = 0; i < len / sizeof(u32); i++) {
+				dst[i] = data[i];
+			}
+			res = _stm32_flashWait();
+			hal_interruptsEnableAll();
+		}
+		else {
+			*(stm32_common.flash + flash_cr) = FLASH_CR_PG;
+			for (i = 0; (i < len / sizeof(u32)) && (res == EOK); i += 2) {
+				dst[i] = data[i];
+				dst[i + 1] = data[i + 1];
+				res = _stm32_flashWait();
+			}
+		}
+	}
+
+	_stm32_flashLock();
+	_stm32_flashCacheReset();
+
+	return res;
 }
 
 
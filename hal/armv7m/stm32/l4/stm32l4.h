@@ -102,6 +102,14 @@ extern int _stm32_getFlashBank(void);
 extern void _stm32_switchFlashBank(int bank);
 
 
+/* Erases page of physical bank (not the one mapped at the flash start), whole bank if page < 0 */
+extern int _stm32_flashErase(int bank, int page);
+
+
+/* Programs double words at addr, fast programs whole row (bank has to be mass erased) */
+extern int _stm32_flashProgram(addr_t addr, const u32 *data, size_t len, int fast);
+
+
 /* Range = 0 - forbidden, 1 - 1.8V, 2 - 1.5V, 3 - 1.2V */
 extern void _stm32_pwrSetCPUVolt(u8 range);
 
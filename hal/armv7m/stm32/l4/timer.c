@@ -30,6 +30,7 @@ static int timer_isr(unsigned int irq, void *data)
 	(void)data;
 
 	timer_common.time += (timer_common.interval + 500) / 1000;
+	hal_timerCyclesUpdate();
 	hal_cpuDataSyncBarrier();
 	return 0;
 }
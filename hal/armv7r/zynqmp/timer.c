@@ -53,6 +53,7 @@ static int timer_isr(unsigned int irq, void *data)
 	/* Interval IRQ */
 	if (st & 0x1) {
 		++timer_common.time;
+		hal_timerCyclesUpdate();
 	}
 
 	/* Clear irq status */
@@ -266,6 +266,19 @@ void hal_cpuReboot(void)
 }
 
 
+void hal_cpuCyclesInit(void)
+{
+	/* DEMCR: enable DWT */
+	*(volatile u32 *)0xe000edfcu |= (1u << 24);
+	hal_cpuDataSyncBarrier();
+
+	/* Unlock DWT (LAR) where implemented and enable CYCCNT */
+	*(volatile u32 *)0xe0001fb0u = 0xc5acce55u;
+	*(volatile u32 *)0xe0001000u |= 1u;
+	hal_cpuDataSyncBarrier();
+}
+
+
 void hal_cpuInit(void)
 {
 	cpu_common.scb = (void *)0xe000ed00u;
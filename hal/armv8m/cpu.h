@@ -53,6 +53,16 @@ static inline void hal_cpuSignalEvent(void)
 }
 
 
+/* Cycle counter - DWT CYCCNT */
+#define HAL_CPU_CYCLES_BITS 32
+#define HAL_CPU_CYCLES_INIT
+
+static inline u32 hal_cpuGetCycles(void)
+{
+	return *(volatile u32 *)0xe0001004;
+}
+
+
 extern void hal_scbSetPriorityGrouping(u32 group);
 
 
@@ -95,4 +105,7 @@ extern void hal_cpuReboot(void);
 extern void hal_cpuInit(void);
 
 
+extern void hal_cpuCyclesInit(void);
+
+
 #endif
@@ -66,6 +66,9 @@ static u64 hal_timerGetCyc(void)
 
 time_t hal_timerGet(void)
 {
+	/* No tick interrupt - extend the cycle counter here, timeouts poll this often enough */
+	hal_timerCyclesUpdate();
+
 	return hal_timerCyc2Us(hal_timerGetCyc()) / 1000;
 }
 
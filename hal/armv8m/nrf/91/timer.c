@@ -53,6 +53,7 @@ static int timer_isr(unsigned int irq, void *data)
 
 	timer_clearEvent();
 	timer_common.time += 1;
+	hal_timerCyclesUpdate();
 	hal_cpuDataSyncBarrier();
 	return 0;
 }
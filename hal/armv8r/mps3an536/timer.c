@@ -40,6 +40,7 @@ static int timer_isr(unsigned int irq, void *data)
 	if ((*(timer_common.base + timer1_mis) & 0x1) != 0) {
 		*(timer_common.base + timer1_intclr) = 0;
 		timer_common.time++;
+		hal_timerCyclesUpdate();
 		hal_cpuDataSyncBarrier();
 	}
 
@@ -93,6 +93,22 @@ extern int hal_interruptsSet(unsigned int irq, int (*isr)(unsigned int, void *),
 extern time_t hal_timerGet(void);
 
 
+/* Function returns value of the free-running high-resolution cycle counter */
+extern u64 hal_timerGetCycles(void) __attribute__((section(".noxip")));
+
+
+/* Function returns frequency of the cycle counter in Hz */
+extern u64 hal_timerGetFreq(void);
+
+
+/* Function returns time in microseconds derived from the cycle counter */
+extern time_t hal_timerGetUs(void);
+
+
+/* Function extends a 32-bit cycle counter, has to be called at least once per counter wrap (e.g. from the tick ISR) */
+extern void hal_timerCyclesUpdate(void) __attribute__((section(".noxip")));
+
+
 /* Function sets early console hooks */
 extern void hal_consoleSetHooks(ssize_t (*writeHook)(int, const void *, size_t));
 
@@ -128,6 +128,21 @@ static inline void hal_outl(u16 addr, u32 l)
 }
 
 
+/* Cycle counter - TSC, frequency calibrated against PIT */
+static inline u64 hal_cpuGetCycles(void)
+{
+	u32 lo, hi;
+
+	/* clang-format off */
+	__asm__ volatile (
+		"rdtsc"
+	: "=a" (lo), "=d" (hi));
+	/* clang-format on */
+
+	return ((u64)hi << 32) | lo;
+}
+
+
 extern void hal_cpuHalt(void);
 
 
@@ -24,24 +24,12 @@ struct {
 } timer_common;
 
 
-static u64 timer_cycles(void)
-{
-	u32 lo, hi;
-
-	__asm__ volatile(
-		"rdtsc; "
-	: "=a" (lo), "=d" (hi));
-
-	return ((u64)hi << 32) | lo;
-}
-
-
 static int timer_isr(unsigned int n, void *arg)
 {
 	static u64 start;
 	u64 t;
 
-	t = timer_cycles();
+	t = hal_cpuGetCycles();
 
 	if (start)
 		timer_common.ratio = 2 * (t - start) / 125;
@@ -54,7 +42,7 @@ static int timer_isr(unsigned int n, void *arg)
 
 time_t hal_timerGet(void)
 {
-	return timer_cycles() / timer_common.ratio;
+	return hal_cpuGetCycles() / timer_common.ratio;
 }
 
 
@@ -115,6 +115,23 @@ static inline void hal_cpuReboot(void)
 }
 
 
+/* Cycle counter - rdtime, constant rate unlike rdcycle */
+#define HAL_CPU_CYCLES_FREQ TIMER_FREQ
+
+static inline u64 hal_cpuGetCycles(void)
+{
+	u64 val;
+	/* clang-format off */
+	__asm__ volatile ("rdtime %0" : "=r"(val));
+	/* clang-format on */
+	return val;
+}
+
+
+/* Makes illegal instructions skipped instead of halting (tests), returns number skipped since the last call */
+extern unsigned int hal_exceptionsIllegalSkip(int enable);
+
+
 static inline unsigned long hal_cpuGetHartId(void)
 {
 	unsigned long id;
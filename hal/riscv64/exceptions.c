@@ -63,6 +63,12 @@ typedef struct _exc_context_t {
 } exc_context_t;
 
 
+static struct {
+	volatile int illegalSkip;
+	volatile unsigned int illegalCnt;
+} exceptions_common;
+
+
 void hal_exceptionsDumpContext(char *buff, exc_context_t *ctx, int n)
 {
 	unsigned int i = 0;
@@ -140,10 +146,28 @@ void hal_exceptionsDumpContext(char *buff, exc_context_t *ctx, int n)
 }
 
 
+unsigned int hal_exceptionsIllegalSkip(int enable)
+{
+	unsigned int cnt = exceptions_common.illegalCnt;
+
+	exceptions_common.illegalCnt = 0;
+	exceptions_common.illegalSkip = enable;
+
+	return cnt;
+}
+
+
 void exceptions_dispatch(unsigned int n, exc_context_t *ctx)
 {
 	char buff[512];
 
+	if ((n == 2) && (exceptions_common.illegalSkip != 0)) {
+		/* Skip instruction, loader runs with identity mapping */
+		ctx->sepc += ((*(volatile u16 *)ctx->sepc & 3) == 3) ? 4 : 2;
+		exceptions_common.illegalCnt++;
+		return;
+	}
+
 	hal_exceptionsDumpContext(buff, ctx, n);
 	hal_consolePrint(buff);
 
@@ -98,6 +98,12 @@ static inline void hal_cpuStoreAlternate32(addr_t addr, const u32 asi, u32 val)
 }
 
 
+/* Cycle counter - 1 MHz timestamp derived from the GPTIMER tick timer */
+#define HAL_CPU_CYCLES_FREQ 1000000
+
+extern u64 hal_cpuGetCycles(void);
+
+
 #endif /* __ASSEMBLY__ */
 
 
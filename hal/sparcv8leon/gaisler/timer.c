@@ -91,6 +91,61 @@ __attribute__((section(".noxip"))) time_t hal_timerGet(void)
 }
 
 
+/* Inlined into .noxip hal_cpuGetCycles() */
+static inline __attribute__((always_inline)) u32 timer_pilGet(void)
+{
+	u32 psr;
+
+	/* clang-format off */
+	__asm__ volatile ("rd %%psr, %0" : "=r" (psr));
+	/* clang-format on */
+
+	return psr & PSR_PIL;
+}
+
+
+/* Traps stay enabled (ET = 1) across the set PIL trap, only PIL is restored */
+static inline __attribute__((always_inline)) void timer_pilSet(u32 pil)
+{
+	/* clang-format off */
+	__asm__ volatile (
+		"mov %0, %%o0\n\t"
+		"ta 0x09\n\t"
+		/* TN-0018 Errata */
+		"nop\n\t"
+		:
+		: "r" (pil)
+		: "%o0", "memory");
+	/* clang-format on */
+}
+
+
+__attribute__((section(".noxip"))) u64 hal_cpuGetCycles(void)
+{
+	time_t time;
+	u32 cnt, pil;
+
+	if (timer_common.gptimer0_base == NULL) {
+		return 0;
+	}
+
+	/* Callers may already run with interrupts masked */
+	pil = timer_pilGet();
+	hal_interruptsDisableAll();
+	time = timer_common.time;
+	cnt = *(timer_common.gptimer0_base + GPT_TCNTVAL(TIMER_DEFAULT));
+	if ((*(timer_common.gptimer0_base + GPT_TCTRL(TIMER_DEFAULT)) & TIMER_INT_PENDING) != 0) {
+		/* Counter reloaded, tick not accounted yet */
+		++time;
+		cnt = *(timer_common.gptimer0_base + GPT_TCNTVAL(TIMER_DEFAULT));
+	}
+	timer_pilSet(pil);
+
+	/* Timer counts down from ticksPerFreq - 1 at 1 MHz */
+	return (u64)time * timer_common.ticksPerFreq + (timer_common.ticksPerFreq - 1 - cnt);
+}
+
+
 void timer_wdogReboot(void)
 {
 	/* Reboot system using watchdog */
@@ -0,0 +1,160 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Operating system loader
+ *
+ * High-resolution timestamps
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#include <hal/hal.h>
+
+
+/* Architecture provides hal_cpuGetCycles() and optionally:
+ * HAL_CPU_CYCLES_BITS - counter width (64 if not defined),
+ * HAL_CPU_CYCLES_FREQ - counter frequency in Hz (calibrated against hal_timerGet() if not defined or 0),
+ * hal_cpuCyclesInit() - counter enable, called before the first read if HAL_CPU_CYCLES_INIT is defined */
+
+#ifndef HAL_CPU_CYCLES_BITS
+#define HAL_CPU_CYCLES_BITS 64
+#endif
+
+/* Calibration window in milliseconds */
+#ifndef HAL_TIMER_CALIB_MS
+#define HAL_TIMER_CALIB_MS 20
+#endif
+
+
+static struct {
+	volatile int init;
+	int calib;
+	u64 freq;
+#if HAL_CPU_CYCLES_BITS < 64
+	/* Written only by hal_timerCyclesUpdate(), readers retry on seq change */
+	volatile u32 seq;
+	volatile u32 last;
+	volatile u32 high;
+#endif
+} timer_common;
+
+
+static void timer_cyclesInit(void)
+{
+#ifdef HAL_CPU_CYCLES_INIT
+	hal_cpuCyclesInit();
+#endif
+#if HAL_CPU_CYCLES_BITS < 64
+	timer_common.last = (u32)hal_cpuGetCycles();
+	timer_common.high = 0;
+#endif
+	hal_cpuDataMemoryBarrier();
+	timer_common.init = 1;
+}
+
+
+__attribute__((section(".noxip"))) void hal_timerCyclesUpdate(void)
+{
+#if HAL_CPU_CYCLES_BITS < 64
+	u32 now;
+
+	if (timer_common.init == 0) {
+		return;
+	}
+
+	now = (u32)hal_cpuGetCycles();
+
+	++timer_common.seq;
+	hal_cpuDataMemoryBarrier();
+	if (now < timer_common.last) {
+		++timer_common.high;
+	}
+	timer_common.last = now;
+	hal_cpuDataMemoryBarrier();
+	++timer_common.seq;
+#endif
+}
+
+
+__attribute__((section(".noxip"))) u64 hal_timerGetCycles(void)
+{
+#if HAL_CPU_CYCLES_BITS < 64
+	u32 seq, last, high, now;
+
+	if (timer_common.init == 0) {
+		timer_cyclesInit();
+	}
+
+	do {
+		seq = timer_common.seq;
+		hal_cpuDataMemoryBarrier();
+		last = timer_common.last;
+		high = timer_common.high;
+		now = (u32)hal_cpuGetCycles();
+		hal_cpuDataMemoryBarrier();
+	} while (seq != timer_common.seq);
+
+	if (now < last) {
+		++high;
+	}
+
+	return ((u64)high << 32) | now;
+#else
+	if (timer_common.init == 0) {
+		timer_cyclesInit();
+	}
+
+	return hal_cpuGetCycles();
+#endif
+}
+
+
+u64 hal_timerGetFreq(void)
+{
+	time_t start, t;
+	u64 c;
+
+	if (timer_common.calib != 0) {
+		return timer_common.freq;
+	}
+	timer_common.calib = 1;
+
+#ifdef HAL_CPU_CYCLES_FREQ
+	timer_common.freq = HAL_CPU_CYCLES_FREQ;
+#endif
+
+	if (timer_common.freq == 0) {
+		/* Start on a tick edge so that both samples are aligned to the millisecond timer */
+		t = hal_timerGet();
+		while ((start = hal_timerGet()) == t) {
+		}
+		c = hal_timerGetCycles();
+
+		while ((hal_timerGet() - start) < HAL_TIMER_CALIB_MS) {
+		}
+		c = hal_timerGetCycles() - c;
+
+		timer_common.freq = (c * 1000) / HAL_TIMER_CALIB_MS;
+	}
+
+	return timer_common.freq;
+}
+
+
+time_t hal_timerGetUs(void)
+{
+	u64 cyc = hal_timerGetCycles();
+	u64 freq = hal_timerGetFreq();
+
+	if (freq == 0) {
+		/* Counter is not running */
+		return hal_timerGet() * 1000;
+	}
+
+	/* Split to avoid overflow of cyc * 1000000 */
+	return (time_t)((cyc / freq) * 1000 * 1000 + ((cyc % freq) * 1000 * 1000) / freq);
+}
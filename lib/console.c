@@ -19,6 +19,9 @@
 #include <devices/devs.h>
 
 
+#define CONSOLE_LOG_MASK (CONSOLE_LOG_SIZE - 1)
+
+
 struct {
 	int init;
 	struct {
@@ -30,6 +33,23 @@ struct {
 	unsigned int minor;
 	ssize_t (*readHook)(int, void *, size_t);
 	ssize_t (*writeHook)(int, const void *, size_t);
+
+	int mode;
+	int flushing;
+
+	/* Log ring, head and tail are free-running, tail marks data already written to the console */
+	struct {
+		char buf[CONSOLE_LOG_SIZE];
+		size_t head;
+		size_t tail;
+	} log;
+
+	/* Optional linear copy of the log passed to the kernel */
+	struct {
+		char *buf;
+		size_t size;
+		size_t len;
+	} rec;
 } console_common = { 0 };
 
 
@@ -40,13 +60,18 @@ void lib_consoleSetHooks(ssize_t (*rd)(int, void *, size_t), ssize_t (*wr)(int,
 }
 
 
-static void lib_consoleWrite(const char *s, size_t len)
+static void lib_consoleDevWrite(const char *s, size_t len)
 {
 	/*
 	 * FIXME: reversing order of writes breaks the mirroring
 	 *        after second user input character on ia32 when mirroring from VGA to UART.
 	 */
 	size_t i;
+
+	if (console_common.writeHook != NULL) {
+		console_common.writeHook(0, s, len);
+	}
+
 	for (i = 0; i < console_common.mirrorsCnt; i++) {
 		devs_write(console_common.mirrors[i].major, console_common.mirrors[i].minor, 0, s, len);
 	}
@@ -54,44 +79,127 @@ static void lib_consoleWrite(const char *s, size_t len)
 }
 
 
-void lib_consolePuts(const char *s)
+static void lib_consoleRecord(const char *s, size_t len)
 {
-	size_t len;
+	size_t n;
 
-	if (console_common.init == 0) {
-		hal_consolePrint(s);
+	if (console_common.rec.buf == NULL) {
 		return;
 	}
 
-	len = hal_strlen(s);
-	if (console_common.writeHook != NULL) {
-		console_common.writeHook(0, s, len);
+	/* Keep the beginning of the log, the rest is truncated */
+	n = min(len, console_common.rec.size - console_common.rec.len);
+	hal_memcpy(console_common.rec.buf + console_common.rec.len, s, n);
+	console_common.rec.len += n;
+}
+
+
+void lib_consoleFlush(void)
+{
+	size_t pos, len;
+
+	if ((console_common.init == 0) || (console_common.flushing != 0) || (console_common.mode == console_modeQuiet)) {
+		return;
 	}
 
-	lib_consoleWrite(s, len);
+	/* Output produced by the console devices themselves is only buffered */
+	console_common.flushing = 1;
+	while (console_common.log.tail != console_common.log.head) {
+		pos = console_common.log.tail & CONSOLE_LOG_MASK;
+		len = min(console_common.log.head - console_common.log.tail, CONSOLE_LOG_SIZE - pos);
+
+		lib_consoleDevWrite(&console_common.log.buf[pos], len);
+		console_common.log.tail += len;
+	}
+	console_common.flushing = 0;
 }
 
 
-void lib_consolePutc(char c)
+static void lib_consoleEarlyWrite(const char *s, size_t len)
 {
-	const char data[] = { c, '\0' };
+	char buf[32];
+	size_t n;
+
+	while (len > 0) {
+		n = min(len, sizeof(buf) - 1);
+		hal_memcpy(buf, s, n);
+		buf[n] = '\0';
+		hal_consolePrint(buf);
+		s += n;
+		len -= n;
+	}
+}
 
-	if (!console_common.init) {
-		hal_consolePrint(data);
-		return;
+
+void lib_consoleWrite(const char *s, size_t len)
+{
+	size_t pos, n;
+
+	if (console_common.init == 0) {
+		lib_consoleEarlyWrite(s, len);
 	}
 
-	if (console_common.writeHook != NULL) {
-		console_common.writeHook(0, &data, 1);
+	lib_consoleRecord(s, len);
+
+	while (len > 0) {
+		if ((console_common.log.head - console_common.log.tail) == CONSOLE_LOG_SIZE) {
+			if ((console_common.init == 0) || (console_common.mode == console_modeQuiet)) {
+				/* Nothing to drain to, drop the oldest data */
+				console_common.log.tail += min(len, CONSOLE_LOG_SIZE);
+			}
+			else if (console_common.flushing != 0) {
+				/* Written by the console device while flushing, drop */
+				break;
+			}
+			else {
+				lib_consoleFlush();
+			}
+		}
+
+		pos = console_common.log.head & CONSOLE_LOG_MASK;
+		n = min(len, CONSOLE_LOG_SIZE - (console_common.log.head - console_common.log.tail));
+		n = min(n, CONSOLE_LOG_SIZE - pos);
+
+		hal_memcpy(&console_common.log.buf[pos], s, n);
+		console_common.log.head += n;
+		s += n;
+		len -= n;
+	}
+
+	if (console_common.init == 0) {
+		/* Early console prints synchronously, the data stays only in the log */
+		console_common.log.tail = console_common.log.head;
 	}
+	else if (console_common.mode == console_modeSync) {
+		lib_consoleFlush();
+	}
+}
+
 
-	lib_consoleWrite(data, 1);
+void lib_consolePuts(const char *s)
+{
+	lib_consoleWrite(s, hal_strlen(s));
+}
+
+
+void lib_consolePutc(char c)
+{
+	lib_consoleWrite(&c, 1);
 }
 
 
 int lib_consoleGetc(char *c, time_t timeout)
 {
+	int res;
+
 	*c = 0;
+
+	/* Waiting for user input in quiet mode means interactive use, show the log */
+	if ((console_common.mode == console_modeQuiet) && (timeout == (time_t)-1)) {
+		console_common.mode = console_modeSync;
+	}
+	lib_consoleFlush();
+
 	if (console_common.readHook != 0) {
 		if (console_common.readHook(0, c, 1) > 0) {
 			return 1;
@@ -111,12 +219,59 @@ int lib_consoleGetc(char *c, time_t timeout)
 		}
 	}
 
-	return devs_read(console_common.major, console_common.minor, 0, c, 1, timeout);
+	res = devs_read(console_common.major, console_common.minor, 0, c, 1, timeout);
+	if ((res > 0) && (console_common.mode == console_modeQuiet)) {
+		/* Boot interrupted by the user */
+		console_common.mode = console_modeSync;
+		lib_consoleFlush();
+	}
+
+	return res;
+}
+
+
+void lib_consoleSetMode(int mode)
+{
+	console_common.mode = mode;
+	lib_consoleFlush();
+}
+
+
+int lib_consoleGetMode(void)
+{
+	return console_common.mode;
+}
+
+
+void lib_consoleSetLog(char *buf, size_t size)
+{
+	size_t len, pos, n;
+
+	console_common.rec.buf = NULL;
+	if (buf == NULL) {
+		return;
+	}
+
+	hal_memset(buf, 0, size);
+	console_common.rec.size = size;
+	console_common.rec.len = 0;
+	console_common.rec.buf = buf;
+
+	/* Start with the log history still held in the ring */
+	len = min(console_common.log.head, CONSOLE_LOG_SIZE);
+	pos = console_common.log.head - len;
+	while (len > 0) {
+		n = min(len, CONSOLE_LOG_SIZE - (pos & CONSOLE_LOG_MASK));
+		lib_consoleRecord(&console_common.log.buf[pos & CONSOLE_LOG_MASK], n);
+		pos += n;
+		len -= n;
+	}
 }
 
 
 void lib_consoleSet(unsigned int major, unsigned int minor)
 {
+	lib_consoleFlush();
 	console_common.major = major;
 	console_common.minor = minor;
 	console_common.init = 1;
@@ -35,6 +35,19 @@
 
 #define CONSOLE_MIRRORS 3
 
+/* Console log ring size, has to be a power of 2 */
+#ifndef CONSOLE_LOG_SIZE
+#define CONSOLE_LOG_SIZE 0x800
+#endif
+
+
+/* Console output modes */
+enum {
+	console_modeSync = 0, /* output written to the console immediately */
+	console_modeBuffered, /* output kept in the log and written on flush or when the log fills up */
+	console_modeQuiet     /* output kept only in the log */
+};
+
 
 /* Sets console device */
 extern void lib_consoleSet(unsigned int major, unsigned int minor);
@@ -48,6 +61,26 @@ extern void lib_consoleSetMirrors(size_t cnt, const unsigned int *major, const u
 void lib_consoleSetHooks(ssize_t (*rd)(int, void *, size_t), ssize_t (*wr)(int, const void *, size_t));
 
 
+/* Sets console output mode */
+extern void lib_consoleSetMode(int mode);
+
+
+/* Returns console output mode */
+extern int lib_consoleGetMode(void);
+
+
+/* Sets buffer receiving a linear copy of the log (e.g. passed to the kernel), NULL disables */
+extern void lib_consoleSetLog(char *buf, size_t size);
+
+
+/* Writes buffered output to the console */
+extern void lib_consoleFlush(void);
+
+
+/* Prints len characters */
+extern void lib_consoleWrite(const char *s, size_t len);
+
+
 /* Prints string */
 extern void lib_consolePuts(const char *s);
 
@@ -0,0 +1,124 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Operating system loader
+ *
+ * Flash erase skipping blank areas
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#include "lib.h"
+
+
+static struct {
+	u32 dirty[FLASHERASE_SCAN_BLOCKS / 32];
+} flasherase_common;
+
+
+int flasherase_isErased(const flasherase_t *fe, addr_t addr, size_t len)
+{
+	ssize_t res;
+	size_t pos, chunk;
+
+	if (fe->isErased != NULL) {
+		return fe->isErased(fe->dev, addr, len);
+	}
+
+	while (len > 0) {
+		chunk = min(len, fe->bufSz);
+		res = fe->read(fe->dev, addr, fe->buf, chunk);
+		if (res < 0) {
+			return res;
+		}
+
+		for (pos = 0; pos < chunk; pos += sizeof(u32)) {
+			if (*(u32 *)(fe->buf + pos) != 0xffffffffu) {
+				return 0;
+			}
+		}
+
+		addr += chunk;
+		len -= chunk;
+	}
+
+	return 1;
+}
+
+
+int flasherase_range(const flasherase_t *fe, addr_t addr, addr_t end)
+{
+	int res;
+	size_t sz;
+
+	while (addr < end) {
+		if ((fe->blockSz != 0) && ((addr & (fe->blockSz - 1u)) == 0) && ((end - addr) >= fe->blockSz)) {
+			sz = fe->blockSz;
+		}
+		else {
+			sz = fe->sectorSz;
+		}
+
+		res = flasherase_isErased(fe, addr, sz);
+		if (res < 0) {
+			return res;
+		}
+
+		if (res == 0) {
+			res = fe->erase(fe->dev, addr, sz);
+			if (res < 0) {
+				return res;
+			}
+		}
+
+		addr += sz;
+	}
+
+	return EOK;
+}
+
+
+/* Chip erase takes roughly as long as erasing every block, it pays off only if most blocks are in use.
+ * The scan records blocks in use, so a mostly blank device is erased without reading it again */
+int flasherase_chip(const flasherase_t *fe, size_t len)
+{
+	int res;
+	size_t i, cnt = 0;
+	const size_t sz = (fe->blockSz != 0) ? fe->blockSz : fe->sectorSz;
+	const size_t blocks = len / sz;
+
+	if (blocks > FLASHERASE_SCAN_BLOCKS) {
+		return fe->eraseChip(fe->dev);
+	}
+
+	hal_memset(flasherase_common.dirty, 0, sizeof(flasherase_common.dirty));
+
+	for (i = 0; i < blocks; i++) {
+		res = flasherase_isErased(fe, i * sz, sz);
+		if (res < 0) {
+			return res;
+		}
+
+		if (res == 0) {
+			flasherase_common.dirty[i / 32] |= 1u << (i % 32);
+			if (++cnt > blocks / 2) {
+				return fe->eraseChip(fe->dev);
+			}
+		}
+	}
+
+	for (i = 0; i < blocks; i++) {
+		if ((flasherase_common.dirty[i / 32] & (1u << (i % 32))) != 0) {
+			res = fe->erase(fe->dev, i * sz, sz);
+			if (res < 0) {
+				return res;
+			}
+		}
+	}
+
+	return EOK;
+}
@@ -0,0 +1,56 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Operating system loader
+ *
+ * Flash erase skipping blank areas
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#ifndef _LIB_FLASHERASE_H_
+#define _LIB_FLASHERASE_H_
+
+#include <hal/hal.h>
+
+
+/* Erase units tracked by the chip erase scan, 256 MiB with 64 KiB blocks */
+#ifndef FLASHERASE_SCAN_BLOCKS
+#define FLASHERASE_SCAN_BLOCKS 4096
+#endif
+
+
+typedef struct {
+	void *dev;
+	size_t sectorSz;
+	size_t blockSz; /* 0 if the device has no block erase */
+
+	/* Blank check reads through buf, unless isErased is provided (e.g. memory mapped flash) */
+	u8 *buf;
+	size_t bufSz;
+	ssize_t (*read)(void *dev, addr_t addr, void *data, size_t len);
+	int (*isErased)(void *dev, addr_t addr, size_t len);
+
+	/* Erases a single sector or block, len is sectorSz or blockSz */
+	int (*erase)(void *dev, addr_t addr, size_t len);
+	int (*eraseChip)(void *dev);
+} flasherase_t;
+
+
+/* Returns 1 if the range is erased, 0 if it is not */
+extern int flasherase_isErased(const flasherase_t *fe, addr_t addr, size_t len);
+
+
+/* Erases sector aligned range skipping blank areas, aligned spans are erased with block erase */
+extern int flasherase_range(const flasherase_t *fe, addr_t addr, addr_t end);
+
+
+/* Erases whole device of len bytes, with chip erase only if most of it is in use */
+extern int flasherase_chip(const flasherase_t *fe, size_t len);
+
+
+#endif
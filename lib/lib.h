@@ -27,6 +27,8 @@
 #include "prompt.h"
 #include "crc32.h"
 #include "ptable.h"
+#include "sfdp.h"
+#include "flasherase.h"
 
 
 #define min(a, b) ({ \
@@ -22,21 +22,41 @@
 extern void lib_formatParse(void *ctx, void (*feed)(void *, char), const char *format, va_list args);
 
 
+typedef struct {
+	size_t n;
+	size_t pos;
+	char buf[64];
+} printf_ctx_t;
+
+
 static void lib_printfFeed(void *context, char c)
 {
-	(*(size_t *)context)++;
-	lib_consolePutc(c);
+	printf_ctx_t *ctx = context;
+
+	ctx->n++;
+	ctx->buf[ctx->pos++] = c;
+	if (ctx->pos == sizeof(ctx->buf)) {
+		lib_consoleWrite(ctx->buf, ctx->pos);
+		ctx->pos = 0;
+	}
 }
 
 
 int lib_printf(const char *format, ...)
 {
 	va_list arg;
-	size_t n = 0;
+	printf_ctx_t ctx;
+
+	ctx.n = 0;
+	ctx.pos = 0;
 
 	va_start(arg, format);
-	lib_formatParse(&n, lib_printfFeed, format, arg);
+	lib_formatParse(&ctx, lib_printfFeed, format, arg);
 	va_end(arg);
 
-	return n;
+	if (ctx.pos != 0) {
+		lib_consoleWrite(ctx.buf, ctx.pos);
+	}
+
+	return ctx.n;
 }
@@ -24,9 +24,27 @@ static inline u32 ptable_crc32(const void *data, size_t len)
 }
 
 
-static int ptable_partVerify(const ptable_t *ptable, const ptable_part_t *part, u32 memsz, u32 blksz, int crcCheck)
+static int ptable_partsCollide(const ptable_part_t *p, const ptable_part_t *part)
+{
+	u32 size = le32toh(part->size);
+	u32 offset = le32toh(part->offset);
+
+	/* Check for range overlap */
+	if ((offset <= le32toh(p->offset) + le32toh(p->size) - 1) && (offset + size - 1 >= le32toh(p->offset))) {
+		return 1;
+	}
+
+	/* Check for name duplicate */
+	if (hal_strcmp((const char *)part->name, (const char *)p->name) == 0) {
+		return 1;
+	}
+
+	return 0;
+}
+
+
+static int ptable_partValid(const ptable_part_t *part, u32 memsz, u32 blksz, int crcCheck)
 {
-	const ptable_part_t *p;
 	size_t i;
 	u32 size = le32toh(part->size);
 	u32 offset = le32toh(part->offset);
@@ -71,15 +89,21 @@ static int ptable_partVerify(const ptable_t *ptable, const ptable_part_t *part,
 		return -1;
 	}
 
-	/* Compare against previous partitions */
-	for (p = ptable->parts; p != part; p++) {
-		/* Check for range overlap */
-		if ((offset <= le32toh(p->offset) + le32toh(p->size) - 1) && (offset + size - 1 >= le32toh(p->offset))) {
-			return -1;
-		}
+	return 0;
+}
 
-		/* Check for name duplicate */
-		if (hal_strcmp((const char *)part->name, (const char *)p->name) == 0) {
+
+static int ptable_partVerify(const ptable_part_t *parts, const ptable_part_t *part, u32 memsz, u32 blksz, int crcCheck)
+{
+	const ptable_part_t *p;
+
+	if (ptable_partValid(part, memsz, blksz, crcCheck) < 0) {
+		return -1;
+	}
+
+	/* Compare against previous partitions */
+	for (p = parts; p != part; p++) {
+		if (ptable_partsCollide(p, part) != 0) {
 			return -1;
 		}
 	}
@@ -88,18 +112,18 @@ static int ptable_partVerify(const ptable_t *ptable, const ptable_part_t *part,
 }
 
 
-static int ptable_verify(const ptable_t *ptable, u32 memsz, u32 blksz)
+static int ptable_crcEnabled(const ptable_t *ptable)
 {
-	u32 size, i;
-	int crcCheck = 1;
-	u32 count = le32toh(ptable->count);
+	/* Disable CRC check for legacy ptables */
+	return ((ptable->version == 0) || (ptable->version == 1) || (ptable->version == 0xff)) ? 0 : 1;
+}
 
-	if (ptable->version == 0 || ptable->version == 1 || ptable->version == 0xff) {
-		/* Disable CRC check for legacy ptables */
-		crcCheck = 0;
-	}
 
-	if (crcCheck != 0) {
+int ptable_hdrVerify(const ptable_t *ptable, u32 blksz)
+{
+	u32 count = le32toh(ptable->count);
+
+	if (ptable_crcEnabled(ptable) != 0) {
 		/* Verify header checksum */
 		if (le32toh(ptable->crc) != ptable_crc32(ptable, offsetof(ptable_t, crc))) {
 			return -1;
@@ -107,19 +131,28 @@ static int ptable_verify(const ptable_t *ptable, u32 memsz, u32 blksz)
 	}
 
 	/* Verify partition table size */
-	size = ptable_size(count);
-	if (size > blksz) {
+	if (ptable_size(count) > blksz) {
 		return -1;
 	}
 
+	return (int)count;
+}
+
+
+static int ptable_partsVerify(const ptable_t *ptable, const ptable_part_t *parts, const u8 *magic, u32 memsz, u32 blksz)
+{
+	u32 i;
+	u32 count = le32toh(ptable->count);
+	int crcCheck = ptable_crcEnabled(ptable);
+
 	/* Verify magic signature */
-	if (hal_memcmp((const u8 *)ptable + size - sizeof(ptable_magic), ptable_magic, sizeof(ptable_magic)) != 0) {
+	if (ptable_magicVerify(magic) < 0) {
 		return -1;
 	}
 
 	/* Verify partitions */
 	for (i = 0; i < count; i++) {
-		if (ptable_partVerify(ptable, ptable->parts + i, memsz, blksz, crcCheck) < 0) {
+		if (ptable_partVerify(parts, parts + i, memsz, blksz, crcCheck) < 0) {
 			return -1;
 		}
 	}
@@ -128,10 +161,45 @@ static int ptable_verify(const ptable_t *ptable, u32 memsz, u32 blksz)
 }
 
 
+static int ptable_verify(const ptable_t *ptable, u32 memsz, u32 blksz)
+{
+	int count = ptable_hdrVerify(ptable, blksz);
+
+	if (count < 0) {
+		return -1;
+	}
+
+	return ptable_partsVerify(ptable, ptable->parts, (const u8 *)ptable + ptable_size(count) - sizeof(ptable_magic), memsz, blksz);
+}
+
+
+int ptable_magicVerify(const u8 *magic)
+{
+	return (hal_memcmp(magic, ptable_magic, sizeof(ptable_magic)) != 0) ? -1 : 0;
+}
+
+
+int ptable_partCheck(const ptable_t *ptable, const ptable_part_t *part, u32 memsz, u32 blksz)
+{
+	return ptable_partValid(part, memsz, blksz, ptable_crcEnabled(ptable));
+}
+
+
+void ptable_partsToHost(ptable_part_t *parts, u32 count)
+{
+	u32 i;
+
+	for (i = 0; i < count; i++) {
+		parts[i].offset = le32toh(parts[i].offset);
+		parts[i].size = le32toh(parts[i].size);
+		parts[i].crc = le32toh(parts[i].crc);
+	}
+}
+
+
 int ptable_deserialize(ptable_t *ptable, u32 memsz, u32 blksz)
 {
 	int ret;
-	u32 i;
 
 	if (ptable == NULL) {
 		return -1;
@@ -146,12 +214,7 @@ int ptable_deserialize(ptable_t *ptable, u32 memsz, u32 blksz)
 	ptable->count = le32toh(ptable->count);
 	ptable->crc = le32toh(ptable->crc);
 
-	for (i = 0; i < ptable->count; i++) {
-		ptable->parts[i].offset = le32toh(ptable->parts[i].offset);
-		ptable->parts[i].size = le32toh(ptable->parts[i].size);
-		ptable->parts[i].crc = le32toh(ptable->parts[i].crc);
-	}
-
+	ptable_partsToHost(ptable->parts, ptable->count);
 
 	return ret;
 }
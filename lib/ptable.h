@@ -87,6 +87,23 @@ static inline u32 ptable_size(u32 count)
 extern int ptable_deserialize(ptable_t *ptable, u32 memsz, u32 blksz);
 
 
+/* Verifies header of partition table read separately from partitions, returns partition count */
+extern int ptable_hdrVerify(const ptable_t *ptable, u32 blksz);
+
+
+/* Verifies magic signature read separately from the header */
+extern int ptable_magicVerify(const u8 *magic);
+
+
+/* Verifies single partition read separately from the header (in little endian),
+ * the caller compares it against the other partitions for overlaps and duplicate names */
+extern int ptable_partCheck(const ptable_t *ptable, const ptable_part_t *part, u32 memsz, u32 blksz);
+
+
+/* Converts verified partitions to host endianness */
+extern void ptable_partsToHost(ptable_part_t *parts, u32 count);
+
+
 /* Verifies partition table and converts it to little endian */
 extern int ptable_serialize(ptable_t *ptable, u32 memsz, u32 blksz);
 
@@ -0,0 +1,242 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Operating system loader
+ *
+ * JEDEC Serial Flash Discoverable Parameters (JESD216)
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#include "sfdp.h"
+#include "errno.h"
+
+
+#define SFDP_SIGNATURE 0x50444653u /* "SFDP" */
+
+#define SFDP_ID_BFPT  0xff00u
+#define SFDP_ID_4BAIT 0xff84u
+
+#define SFDP_BFPT_DWORDS_MAX 20
+#define SFDP_HDRS_MAX        16
+
+
+typedef struct {
+	u32 signature;
+	u8 minor;
+	u8 major;
+	u8 nph; /* Number of parameter headers - 1 */
+	u8 protocol;
+} __attribute__((packed)) sfdp_hdr_t;
+
+
+typedef struct {
+	u8 idLsb;
+	u8 minor;
+	u8 major;
+	u8 len; /* Length in DWORDs */
+	u8 ptr[3];
+	u8 idMsb;
+} __attribute__((packed)) sfdp_paramHdr_t;
+
+
+static u32 sfdp_field(u32 dword, unsigned int lsb, unsigned int bits)
+{
+	return (dword >> lsb) & ((1u << bits) - 1u);
+}
+
+
+/* Converts count/units time field to ms */
+static u32 sfdp_time(u32 count, u32 unit)
+{
+	return (count + 1u) * unit;
+}
+
+
+static int sfdp_readTable(sfdp_read_fn read, void *arg, const sfdp_paramHdr_t *hdr, u32 *dwords, unsigned int max)
+{
+	u32 ptr = hdr->ptr[0] | ((u32)hdr->ptr[1] << 8) | ((u32)hdr->ptr[2] << 16);
+	unsigned int len = (hdr->len < max) ? hdr->len : max;
+
+	hal_memset(dwords, 0, max * sizeof(u32));
+
+	/* SFDP is little endian, as are all supported targets */
+	return read(arg, ptr, dwords, len * sizeof(u32));
+}
+
+
+static void sfdp_parseRead(sfdp_read_t *read, u32 field, u8 defOpCode)
+{
+	read->opCode = sfdp_field(field, 8, 8);
+	read->dummyClk = sfdp_field(field, 0, 5) + sfdp_field(field, 5, 3);
+
+	/* Some parts leave opcode erased */
+	if ((read->opCode == 0) || (read->opCode == 0xff)) {
+		read->opCode = defOpCode;
+	}
+}
+
+
+static void sfdp_parseBfpt(sfdp_info_t *info, const u32 *dw, unsigned int len)
+{
+	static const u32 ceUnits[] = { 16, 256, 4000, 64000 };
+	static const u32 eraseUnits[] = { 1, 16, 128, 1000 };
+	unsigned int i;
+	u32 field, mult;
+
+	/* DWORD 1 */
+	info->addrBytes = sfdp_field(dw[0], 17, 2);
+	info->dtr = sfdp_field(dw[0], 19, 1);
+
+	/* DWORD 2 - density in bits */
+	if ((dw[1] & (1u << 31)) != 0) {
+		info->size = (1ull << sfdp_field(dw[1], 0, 31)) / 8u;
+	}
+	else {
+		info->size = ((u64)dw[1] + 1u) / 8u;
+	}
+
+	/* DWORD 3, 4 - fast read modes, 1-1-1 fast read is always supported */
+	info->read[sfdp_read_1_1_1].opCode = 0x0b;
+	info->read[sfdp_read_1_1_1].dummyClk = 8;
+
+	if (sfdp_field(dw[0], 21, 1) != 0) {
+		sfdp_parseRead(&info->read[sfdp_read_1_4_4], sfdp_field(dw[2], 0, 16), 0xeb);
+	}
+	if (sfdp_field(dw[0], 22, 1) != 0) {
+		sfdp_parseRead(&info->read[sfdp_read_1_1_4], sfdp_field(dw[2], 16, 16), 0x6b);
+	}
+	if (sfdp_field(dw[0], 16, 1) != 0) {
+		sfdp_parseRead(&info->read[sfdp_read_1_1_2], sfdp_field(dw[3], 0, 16), 0x3b);
+	}
+	if (sfdp_field(dw[0], 20, 1) != 0) {
+		sfdp_parseRead(&info->read[sfdp_read_1_2_2], sfdp_field(dw[3], 16, 16), 0xbb);
+	}
+
+	/* DWORD 8, 9 - erase types */
+	for (i = 0; i < SFDP_ERASE_TYPES; i++) {
+		field = sfdp_field(dw[7 + i / 2], (i % 2) * 16, 16);
+		if (sfdp_field(field, 0, 8) != 0) {
+			info->erase[i].size = 1u << sfdp_field(field, 0, 8);
+			info->erase[i].opCode = sfdp_field(field, 8, 8);
+		}
+	}
+
+	/* JESD216 rev. A and later */
+	if (len >= 11) {
+		/* DWORD 10 - erase times */
+		mult = 2u * (sfdp_field(dw[9], 0, 4) + 1u);
+		for (i = 0; i < SFDP_ERASE_TYPES; i++) {
+			field = sfdp_field(dw[9], 4 + i * 7, 7);
+			info->erase[i].timeTyp = sfdp_time(sfdp_field(field, 0, 5), eraseUnits[sfdp_field(field, 5, 2)]);
+			info->erase[i].timeMax = info->erase[i].timeTyp * mult;
+		}
+
+		/* DWORD 11 - page size, program and chip erase times */
+		mult = 2u * (sfdp_field(dw[10], 0, 4) + 1u);
+		info->pageSz = 1u << sfdp_field(dw[10], 4, 4);
+		info->ppTyp = sfdp_time(sfdp_field(dw[10], 8, 5), (sfdp_field(dw[10], 13, 1) != 0) ? 64 : 8);
+		info->ppMax = info->ppTyp * mult;
+		info->ceTyp = sfdp_time(sfdp_field(dw[10], 24, 5), ceUnits[sfdp_field(dw[10], 29, 2)]);
+		info->ceMax = info->ceTyp * mult;
+	}
+
+	if (len >= 15) {
+		/* DWORD 15 - quad enable requirements */
+		info->qer = sfdp_field(dw[14], 20, 3);
+	}
+	else if ((info->read[sfdp_read_1_4_4].opCode != 0) || (info->read[sfdp_read_1_1_4].opCode != 0)) {
+		/* Most common legacy QE location */
+		info->qer = sfdp_qerSr2b1Wrsr2;
+	}
+}
+
+
+static void sfdp_parse4bait(sfdp_info_t *info, const u32 *dw)
+{
+	unsigned int i;
+
+	info->addr4 = dw[0];
+
+	/* DWORD 2 - 4-byte erase opcodes */
+	for (i = 0; i < SFDP_ERASE_TYPES; i++) {
+		if ((info->erase[i].size != 0) && ((info->addr4 & (sfdp_4b_erase1 << i)) != 0)) {
+			info->erase[i].opCode4 = sfdp_field(dw[1], i * 8, 8);
+		}
+	}
+}
+
+
+int sfdp_parse(sfdp_info_t *info, sfdp_read_fn read, void *arg)
+{
+	sfdp_hdr_t hdr;
+	sfdp_paramHdr_t phdr, bfpt;
+	u32 dwords[SFDP_BFPT_DWORDS_MAX];
+	unsigned int i, nph;
+	int res, bfptFound = 0, bait = -1;
+
+	hal_memset(info, 0, sizeof(*info));
+
+	res = read(arg, 0, &hdr, sizeof(hdr));
+	if (res < 0) {
+		return res;
+	}
+
+	if ((hdr.signature != SFDP_SIGNATURE) || (hdr.major != 1)) {
+		return -ENOENT;
+	}
+
+	nph = (hdr.nph < SFDP_HDRS_MAX) ? (hdr.nph + 1u) : SFDP_HDRS_MAX;
+
+	for (i = 0; i < nph; i++) {
+		res = read(arg, sizeof(hdr) + i * sizeof(phdr), &phdr, sizeof(phdr));
+		if (res < 0) {
+			return res;
+		}
+
+		switch (((u16)phdr.idMsb << 8) | phdr.idLsb) {
+			case SFDP_ID_BFPT:
+				/* Use the latest compatible revision */
+				if ((phdr.major == 1) && ((bfptFound == 0) || (phdr.minor >= bfpt.minor))) {
+					bfpt = phdr;
+					bfptFound = 1;
+				}
+				break;
+
+			case SFDP_ID_4BAIT:
+				bait = i;
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	/* BFPT is mandatory */
+	if ((bfptFound == 0) || (bfpt.len < 9)) {
+		return -ENOENT;
+	}
+
+	res = sfdp_readTable(read, arg, &bfpt, dwords, SFDP_BFPT_DWORDS_MAX);
+	if (res < 0) {
+		return res;
+	}
+
+	info->major = bfpt.major;
+	info->minor = bfpt.minor;
+	sfdp_parseBfpt(info, dwords, bfpt.len);
+
+	if (bait >= 0) {
+		/* Optional table, ignore errors */
+		res = read(arg, sizeof(hdr) + bait * sizeof(phdr), &phdr, sizeof(phdr));
+		if ((res >= 0) && (phdr.len >= 2) && (sfdp_readTable(read, arg, &phdr, dwords, 2) >= 0)) {
+			sfdp_parse4bait(info, dwords);
+		}
+	}
+
+	return EOK;
+}
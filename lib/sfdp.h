@@ -0,0 +1,92 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Operating system loader
+ *
+ * JEDEC Serial Flash Discoverable Parameters (JESD216)
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#ifndef _LIB_SFDP_H_
+#define _LIB_SFDP_H_
+
+#include <hal/hal.h>
+
+
+/* Read SFDP command: 3-byte address, 8 dummy clocks, single line */
+#define SFDP_CMD_RDSFDP     0x5a
+#define SFDP_CMD_DUMMY_CLKS 8
+
+#define SFDP_ERASE_TYPES 4
+
+
+/* Fast read modes (command-address-data lines) in order of increasing speed */
+/* clang-format off */
+enum { sfdp_read_1_1_1 = 0, sfdp_read_1_1_2, sfdp_read_1_2_2, sfdp_read_1_1_4, sfdp_read_1_4_4, sfdp_read_end };
+
+
+/* Address bytes */
+enum { sfdp_addr3 = 0, sfdp_addr3or4, sfdp_addr4 };
+
+
+/* Quad enable requirements (BFPT DWORD 15) */
+enum { sfdp_qerNone = 0, sfdp_qerSr2b1Wrsr2, sfdp_qerSr1b6, sfdp_qerSr2b7, sfdp_qerSr2b1Wrsr2NoRd, sfdp_qerSr2b1Rd35, sfdp_qerSr2b1Wr31 };
+
+
+/* 4-byte address instructions (4BAIT DWORD 1) */
+enum { sfdp_4b_read = 0x1, sfdp_4b_fastRead = 0x2, sfdp_4b_read_1_1_2 = 0x4, sfdp_4b_read_1_2_2 = 0x8,
+	sfdp_4b_read_1_1_4 = 0x10, sfdp_4b_read_1_4_4 = 0x20, sfdp_4b_pp = 0x40, sfdp_4b_pp_1_1_4 = 0x80,
+	sfdp_4b_pp_1_4_4 = 0x100, sfdp_4b_erase1 = 0x200, sfdp_4b_dtrRead_1_4_4 = 0x8000 };
+/* clang-format on */
+
+
+typedef struct {
+	u8 opCode;   /* 0 if mode is not supported */
+	u8 dummyClk; /* Mode and wait state clocks */
+} sfdp_read_t;
+
+
+typedef struct {
+	u32 size;     /* Erase size in bytes, 0 if erase type is not supported */
+	u8 opCode;    /* 3-byte address opcode */
+	u8 opCode4;   /* 4-byte address opcode, 0 if not supported */
+	u32 timeTyp;  /* Typical time [ms] */
+	u32 timeMax;  /* Max time [ms] */
+} sfdp_erase_t;
+
+
+typedef struct {
+	u8 major; /* BFPT revision */
+	u8 minor;
+
+	u64 size;     /* Flash size in bytes */
+	u32 pageSz;   /* Page size in bytes */
+	u8 addrBytes; /* Supported addressing */
+	u8 dtr;       /* DTR clocking supported */
+	u8 qer;       /* Quad enable requirements */
+	u32 addr4;    /* Supported 4-byte address instructions */
+
+	sfdp_read_t read[sfdp_read_end];
+	sfdp_erase_t erase[SFDP_ERASE_TYPES];
+
+	u32 ppTyp;  /* Page program typical time [us] */
+	u32 ppMax;  /* Page program max time [us] */
+	u32 ceTyp;  /* Chip erase typical time [ms] */
+	u32 ceMax;  /* Chip erase max time [ms] */
+} sfdp_info_t;
+
+
+/* Reads len bytes of SFDP space at addr, returns <0 on error */
+typedef int (*sfdp_read_fn)(void *arg, u32 addr, void *buff, size_t len);
+
+
+/* Parses JEDEC Basic Flash Parameter Table and 4-byte Address Instruction Table */
+extern int sfdp_parse(sfdp_info_t *info, sfdp_read_fn read, void *arg);
+
+
+#endif
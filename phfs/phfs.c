@@ -17,6 +17,7 @@
 #include "phoenixd.h"
 
 #include <lib/lib.h>
+#include <warmboot.h>
 
 #define SIZE_PHFS_HANDLERS 8
 #define SIZE_PHFS_ALIASES  32
@@ -226,6 +227,27 @@ static int phfs_getAliasId(const char *alias)
 }
 
 
+int phfs_aliasGet(const char *alias, addr_t *addr, size_t *size)
+{
+	int id;
+
+	if (alias == NULL)
+		return -EINVAL;
+
+	id = phfs_getAliasId(alias);
+	if (id < 0)
+		return -ENOENT;
+
+	if (addr != NULL)
+		*addr = phfs_common.files[id].addr;
+
+	if (size != NULL)
+		*size = phfs_common.files[id].size;
+
+	return EOK;
+}
+
+
 int phfs_aliasReg(const char *alias, addr_t addr, size_t size)
 {
 	size_t sz;
@@ -360,6 +382,9 @@ ssize_t phfs_write(handler_t handler, addr_t offs, const void *buff, size_t len)
 			return phoenixd_write(handler.id, pd->major, pd->minor, offs, buff, len);
 
 		case phfs_prot_raw:
+			/* Source of the images kept in memory may change */
+			warmboot_invalidate();
+
 			/* Writing raw data to device */
 			if (handler.id == -1)
 				return devs_write(pd->major, pd->minor, offs, buff, len);
@@ -393,10 +418,25 @@ ssize_t phfs_erase(handler_t handler, addr_t offs, size_t len, unsigned int flag
 		return -EINVAL;
 	}
 
+	warmboot_invalidate();
+
 	return devs_erase(pd->major, pd->minor, offs, len, flags);
 }
 
 
+int phfs_sync(handler_t handler)
+{
+	phfs_device_t *pd;
+
+	if (handler.pd >= SIZE_PHFS_HANDLERS)
+		return -EINVAL;
+
+	pd = &phfs_common.devices[handler.pd];
+
+	return devs_sync(pd->major, pd->minor);
+}
+
+
 int phfs_close(handler_t handler)
 {
 	int res;
@@ -56,6 +56,10 @@ extern int phfs_aliasReg(const char *alias, addr_t addr, size_t size);
 int phfs_devGet(const char *alias, unsigned int *retMajor, unsigned int *retMinor, unsigned int *retProt);
 
 
+/* Get address and size of the registered file alias */
+extern int phfs_aliasGet(const char *alias, addr_t *addr, size_t *size);
+
+
 /* Get file's address based on the given handler */
 extern int phfs_aliasAddrResolve(handler_t h, addr_t *addr);
 
@@ -86,6 +90,10 @@ extern ssize_t phfs_write(handler_t handler, addr_t offs, const void *buff, size
 extern ssize_t phfs_erase(handler_t handler, addr_t offs, size_t len, unsigned int flags);
 
 
+/* Flush data written to registered device */
+extern int phfs_sync(handler_t handler);
+
+
 /* Close connection with the device */
 extern int phfs_close(handler_t handler);
 
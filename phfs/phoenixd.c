@@ -126,9 +126,8 @@ ssize_t phoenixd_read(unsigned int fd, unsigned int major, unsigned int minor, a
 
 	io = (msg_phoenixd_t *)smsg.data;
 
-	if (len > (MSG_MAXLEN - PHOENIXD_HDRSZ)) {
-		return -EINVAL;
-	}
+	/* Transfer is limited to a single message, caller handles partial transfers */
+	len = min(len, MSG_MAXLEN - PHOENIXD_HDRSZ);
 
 	phoenixd_serializeMsgPhd(smsg.data, fd, offs, len);
 
@@ -167,9 +166,8 @@ ssize_t phoenixd_write(unsigned int fd, unsigned int major, unsigned int minor,
 
 	io = (msg_phoenixd_t *)smsg.data;
 
-	if (len > (MSG_MAXLEN - PHOENIXD_HDRSZ)) {
-		return -EINVAL;
-	}
+	/* Transfer is limited to a single message, caller handles partial transfers */
+	len = min(len, MSG_MAXLEN - PHOENIXD_HDRSZ);
 
 	phoenixd_serializeDataMsgPhd(smsg.data, fd, offs, len, buff);
 
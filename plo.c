@@ -41,6 +41,7 @@ int main(void)
 	lib_printf(CONSOLE_CURSOR_SHOW CONSOLE_NORMAL);
 	cmd_prompt();
 
+	lib_consoleFlush();
 	devs_done();
 	hal_done();
 	hal_customDone();
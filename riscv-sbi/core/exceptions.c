@@ -19,6 +19,7 @@
 #include "types.h"
 
 #include "devices/console.h"
+#include "extensions/pmu.h"
 
 
 typedef struct _exc_context_t {
@@ -282,6 +283,8 @@ static void exceptions_illegalHandler(unsigned int n, exc_context_t *ctx)
 	u64 prevMode = (ctx->mstatus & MSTATUS_MPP) >> MSTATUS_MPP_SHIFT;
 	unsigned long unpriv_insn;
 
+	pmu_fwEventAdd(SBI_PMU_FW_ILLEGAL_INSN, 1);
+
 	/* Check failing instruction */
 	if (((insn & 3) == 3) && (((insn & 0x7c) >> 2) == 0x1c)) {
 		/* Non-compressed, SYSTEM opcode */
@@ -13,12 +13,24 @@
  * %LICENSE%
  */
 
+#include "atomic.h"
+#include "csr.h"
+#include "hart.h"
 #include "sbi.h"
+
 #include "extensions/ipi.h"
+#include "extensions/pmu.h"
+
+#include "ld/noelv.ldt"
 
 
 #define SFENCE_VMA_FLUSH_ALL (size_t)(-1)
 
+/* Ranges above this size are flushed entirely (or per ASID) instead of page by page */
+#ifndef RFENCE_FLUSH_LIMIT
+#define RFENCE_FLUSH_LIMIT (64 * PAGE_SIZE)
+#endif
+
 
 enum {
 	RFENCE_FENCE_I = 0,
@@ -35,13 +47,44 @@ typedef struct {
 	addr_t start;
 	size_t size;
 	u32 asid;
+	u64 seq;
 } sfenceVmaInfo_t;
 
 
+/* Every request gets a sequence number. A hart doing a full flush records
+ * the sequence number it started at, requests up to it are already covered
+ * and are skipped when several of them reach the hart at once.
+ */
+static struct {
+	volatile u64 seq;
+	u64 flushed[MAX_HART_COUNT];
+} rfence_common;
+
+
+static int ecall_rfence_isFull(const sfenceVmaInfo_t *info)
+{
+	return (((info->start == 0) && (info->size == 0)) || (info->size == SFENCE_VMA_FLUSH_ALL) ||
+		(info->size > RFENCE_FLUSH_LIMIT) || (info->start + info->size < info->start));
+}
+
+
+static int ecall_rfence_covered(const sfenceVmaInfo_t *info, u32 hartid)
+{
+	if (info->seq <= rfence_common.flushed[hartid]) {
+		pmu_fwEventAdd(PMU_FW_PLAT(PMU_PLAT_RFENCE_COALESCED), 1);
+		return 1;
+	}
+
+	return 0;
+}
+
+
 static void ecall_rfence_fenceiHandler(void *data)
 {
 	(void)data;
 
+	pmu_fwEventAdd(SBI_PMU_FW_FENCE_I_RECEIVED, 1);
+
 	__asm__ volatile("fence.i");
 }
 
@@ -49,11 +92,22 @@ static void ecall_rfence_fenceiHandler(void *data)
 static void ecall_rfence_sfenceVmaHandler(void *data)
 {
 	size_t i;
+	u64 seq;
+	u32 hartid = csr_read(CSR_MHARTID);
 	sfenceVmaInfo_t *info = (sfenceVmaInfo_t *)data;
 
-	if (((info->start == 0) && (info->size == 0)) || (info->size == SFENCE_VMA_FLUSH_ALL)) {
+	pmu_fwEventAdd(SBI_PMU_FW_SFENCE_VMA_RECEIVED, 1);
+
+	if (ecall_rfence_covered(info, hartid) != 0) {
+		return;
+	}
+
+	if (ecall_rfence_isFull(info) != 0) {
+		seq = ATOMIC_READ(&rfence_common.seq);
 		__asm__ volatile("sfence.vma" ::: "memory");
+		rfence_common.flushed[hartid] = seq;
 
+		pmu_fwEventAdd(PMU_FW_PLAT(PMU_PLAT_RFENCE_FLUSHALL), 1);
 		return;
 	}
 
@@ -67,15 +121,24 @@ static void ecall_rfence_sfenceVmaHandler(void *data)
 		);
 		/* clang-format on */
 	}
+
+	pmu_fwEventAdd(PMU_FW_PLAT(PMU_PLAT_RFENCE_PAGES), (info->size + PAGE_SIZE - 1) / PAGE_SIZE);
 }
 
 
 static void ecall_rfence_sfenceVmaAsidHandler(void *data)
 {
 	size_t i;
+	u32 hartid = csr_read(CSR_MHARTID);
 	sfenceVmaInfo_t *info = (sfenceVmaInfo_t *)data;
 
-	if (((info->start == 0) && (info->size == 0)) || (info->size == SFENCE_VMA_FLUSH_ALL)) {
+	pmu_fwEventAdd(SBI_PMU_FW_SFENCE_VMA_ASID_RECEIVED, 1);
+
+	if (ecall_rfence_covered(info, hartid) != 0) {
+		return;
+	}
+
+	if (ecall_rfence_isFull(info) != 0) {
 		/* clang-format off */
 		__asm__ volatile (
 			"sfence.vma x0, %0"
@@ -85,10 +148,10 @@ static void ecall_rfence_sfenceVmaAsidHandler(void *data)
 		);
 		/* clang-format on */
 
+		pmu_fwEventAdd(PMU_FW_PLAT(PMU_PLAT_RFENCE_FLUSHALL), 1);
 		return;
 	}
 
-
 	for (i = 0; i < info->size; i += PAGE_SIZE) {
 		/* clang-format off */
 		__asm__ volatile (
@@ -99,6 +162,8 @@ static void ecall_rfence_sfenceVmaAsidHandler(void *data)
 		);
 		/* clang-format on */
 	}
+
+	pmu_fwEventAdd(PMU_FW_PLAT(PMU_PLAT_RFENCE_PAGES), (info->size + PAGE_SIZE - 1) / PAGE_SIZE);
 }
 
 
@@ -109,19 +174,24 @@ static sbiret_t ecall_rfence_handler(sbi_param a0, sbi_param a1, sbi_param a2, s
 
 	switch (fid) {
 		case RFENCE_FENCE_I:
+			pmu_fwEventAdd(SBI_PMU_FW_FENCE_I_SENT, 1);
 			ret.error = sbi_ipiSendMany(a0, a1, ecall_rfence_fenceiHandler, NULL);
 			break;
 
 		case RFENCE_SFENCE_VMA:
+			pmu_fwEventAdd(SBI_PMU_FW_SFENCE_VMA_SENT, 1);
 			info.start = a2;
 			info.size = a3;
+			info.seq = atomic_fetchAdd64(&rfence_common.seq, 1) + 1;
 			ret.error = sbi_ipiSendMany(a0, a1, ecall_rfence_sfenceVmaHandler, &info);
 			break;
 
 		case RFENCE_SFENCE_VMA_ASID:
+			pmu_fwEventAdd(SBI_PMU_FW_SFENCE_VMA_ASID_SENT, 1);
 			info.start = a2;
 			info.size = a3;
 			info.asid = a4;
+			info.seq = atomic_fetchAdd64(&rfence_common.seq, 1) + 1;
 			ret.error = sbi_ipiSendMany(a0, a1, ecall_rfence_sfenceVmaAsidHandler, &info);
 			break;
 
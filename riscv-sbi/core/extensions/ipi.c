@@ -13,11 +13,10 @@
  * %LICENSE%
  */
 
+#include "atomic.h"
 #include "csr.h"
 #include "hart.h"
-#include "list.h"
 #include "sbi.h"
-#include "spinlock.h"
 #include "string.h"
 
 #include "devices/clint.h"
@@ -26,102 +25,147 @@
 #include "ld/noelv.ldt"
 
 
-#define MAX_TASK_COUNT 16
+/* Time (in mtime ticks) after which tasks not yet picked up by targets are withdrawn */
+#ifndef SBI_IPI_TIMEOUT
+#define SBI_IPI_TIMEOUT 10000000
+#endif
 
-#define SBI_IPI_RETRY 1
 
-
-typedef struct _ipi_node_t {
-	ipi_task_t task;
-	struct _ipi_node_t *next;
-	struct _ipi_node_t *prev;
-} ipi_node_t;
+/* Each hart owns one mailbox. A sender keeps at most one task in flight
+ * (it waits for completion or withdraws the task before returning), so the
+ * mailbox holds a task slot per source hart and a mask of sources with a
+ * task posted. Posting and draining are single AMOs, no locks are involved.
+ */
+typedef struct {
+	volatile u64 pending;
+	ipi_task_t *volatile task[MAX_HART_COUNT];
+} __attribute__((aligned(64))) ipi_mailbox_t;
 
 
-struct {
-	spinlock_t lock[MAX_HART_COUNT];
-	u16 poolMask[MAX_HART_COUNT];
-	ipi_node_t pool[MAX_HART_COUNT][MAX_TASK_COUNT];
-	ipi_node_t *tasks[MAX_HART_COUNT];
+static struct {
+	ipi_mailbox_t mbox[MAX_HART_COUNT];
 } ipi_common;
 
 
-static void sbi_ipiRawSend(u32 hartid)
+static void sbi_ipiRawClear(u32 hartid)
 {
+	clint_clearIpi(hartid);
 	RISCV_FENCE(ow, ow);
-	clint_sendIpi(hartid);
 }
 
 
-static void sbi_ipiRawClear(u32 hartid)
+static void sbi_ipiPost(u32 hartid, u32 self, ipi_task_t *task)
 {
-	clint_clearIpi(hartid);
-	RISCV_FENCE(ow, ow);
+	ipi_mailbox_t *mbox = &ipi_common.mbox[hartid];
+
+	mbox->task[self] = task;
+
+	/* Release - task slot is visible before the pending bit */
+	atomic_or64(&mbox->pending, 1UL << self);
 }
 
 
-void sbi_ipiHandler(void)
+static void sbi_ipiProcess(u32 hartid)
 {
-	spinlock_ctx_t ctx;
-	u32 hartid = csr_read(CSR_MHARTID);
-	ipi_node_t *node;
+	ipi_mailbox_t *mbox = &ipi_common.mbox[hartid];
+	ipi_task_t *task;
+	u64 pending;
+	unsigned int src;
 
-	sbi_ipiRawClear(hartid);
+	pending = atomic_swap64(&mbox->pending, 0);
 
-	spinlock_set(&ipi_common.lock[hartid], &ctx);
+	while (pending != 0) {
+		src = sbi_getFirstBit(pending);
+		pending &= ~(1UL << src);
 
-	node = ipi_common.tasks[hartid];
+		task = mbox->task[src];
+		if (task->handler != NULL) {
+			task->handler(task->data);
+		}
+
+		/* Task lives on sender's stack, it may be gone right after the countdown */
+		RISCV_FENCE(rw, rw);
+		atomic_add32(&task->count, (u32)-1);
+	}
+}
 
-	while (node != NULL) {
-		LIST_REMOVE(&ipi_common.tasks[hartid], node);
-		if (node->task.handler != NULL) {
-			node->task.handler(node->task.data);
+
+/* Waits for targets to run the task, returns number of targets which didn't run it in time */
+static u32 sbi_ipiWait(u32 self, unsigned long targets, ipi_task_t *task)
+{
+	u64 start = clint_getTime();
+	unsigned long mask;
+	u32 i, missed = 0;
+	int withdrawn = 0;
+
+	while (ATOMIC_READ(&task->count) != 0) {
+		/* Targets may be waiting for us as well, keep draining own mailbox */
+		sbi_ipiProcess(self);
+
+		if ((withdrawn == 0) && ((clint_getTime() - start) > SBI_IPI_TIMEOUT)) {
+			/* Task lives on our stack - withdraw it from mailboxes which haven't drained it yet.
+			 * Targets which already did are running the handler and will count down shortly */
+			for (mask = targets; mask != 0; mask &= ~(1UL << i)) {
+				i = sbi_getFirstBit(mask);
+				if ((atomic_fetchAnd64(&ipi_common.mbox[i].pending, ~(1UL << self)) & (1UL << self)) != 0) {
+					atomic_add32(&task->count, (u32)-1);
+					missed++;
+				}
+			}
+			withdrawn = 1;
 		}
-		ipi_common.poolMask[hartid] |= 1 << (node - ipi_common.pool[hartid]);
-		node = ipi_common.tasks[hartid];
 	}
 
-	spinlock_clear(&ipi_common.lock[hartid], &ctx);
+	return missed;
+}
+
+
+/* Harts which aren't started don't service IPIs, tasks are not posted to them */
+static int sbi_ipiIsStarted(u32 hartid)
+{
+	return (ATOMIC_READ(&sbi_getPerHartData(hartid)->state) == SBI_HSM_STARTED) ? 1 : 0;
+}
+
+
+void sbi_ipiHandler(void)
+{
+	u32 hartid = csr_read(CSR_MHARTID);
+
+	sbi_ipiRawClear(hartid);
+	sbi_ipiProcess(hartid);
 }
 
 
 long sbi_ipiSend(u32 hartid, void (*handler)(void *), void *data)
 {
-	size_t idx;
-	spinlock_ctx_t ctx;
-	ipi_node_t *node;
+	ipi_task_t task;
+	u32 self = csr_read(CSR_MHARTID);
 
-	if (hartid == csr_read(CSR_MHARTID)) {
+	if (hartid == self) {
 		if (handler != NULL) {
 			handler(data);
 		}
 		return SBI_SUCCESS;
 	}
 
-	spinlock_set(&ipi_common.lock[hartid], &ctx);
+	if (handler != NULL) {
+		if (sbi_ipiIsStarted(hartid) == 0) {
+			return SBI_SUCCESS;
+		}
 
-	if (ipi_common.poolMask[hartid] == 0) {
-		spinlock_clear(&ipi_common.lock[hartid], &ctx);
-		return SBI_IPI_RETRY;
+		task.handler = handler;
+		task.data = data;
+		task.count = 1;
+		sbi_ipiPost(hartid, self, &task);
 	}
 
-	idx = sbi_getFirstBit(ipi_common.poolMask[hartid]);
-	ipi_common.poolMask[hartid] &= ~(1 << idx);
-
-	node = &ipi_common.pool[hartid][idx];
-	node->task.handler = handler;
-	node->task.data = data;
+	/* Raw IPI (without a task) wakes harts pending start as well */
+	RISCV_FENCE(ow, ow);
+	clint_sendIpi(hartid);
 
-	if (ipi_common.tasks[hartid] == NULL) {
-		LIST_ADD(&ipi_common.tasks[hartid], node);
+	if ((handler != NULL) && (sbi_ipiWait(self, 1UL << hartid, &task) != 0)) {
+		return SBI_ERR_FAILED;
 	}
-	else {
-		LIST_ADD(&ipi_common.tasks[hartid]->prev, node);
-	}
-
-	sbi_ipiRawSend(hartid);
-
-	spinlock_clear(&ipi_common.lock[hartid], &ctx);
 
 	return SBI_SUCCESS;
 }
@@ -129,10 +173,14 @@ long sbi_ipiSend(u32 hartid, void (*handler)(void *), void *data)
 
 long sbi_ipiSendMany(unsigned long hartMask, unsigned long hartMaskBase, void (*handler)(void *), void *data)
 {
-	size_t i;
-	long ret;
+	ipi_task_t task;
+	unsigned long targets, mask;
+	u32 i, self = csr_read(CSR_MHARTID);
 
-	if (hartMaskBase > sbi_getHartCount()) {
+	if (hartMaskBase == SBI_HARTMASK_ALL) {
+		hartMask = sbi_hartMask;
+	}
+	else if (hartMaskBase > sbi_getHartCount()) {
 		return SBI_ERR_INVALID_PARAM;
 	}
 	else {
@@ -143,17 +191,41 @@ long sbi_ipiSendMany(unsigned long hartMask, unsigned long hartMaskBase, void (*
 		return SBI_ERR_INVALID_PARAM;
 	}
 
-	for (i = 0; i < sbi_getHartCount(); i++) {
-		if (hartMask & (1 << i)) {
-			do {
-				ret = sbi_ipiSend(i, handler, data);
-				/* We might run out of IPI slots, retry */
-			} while (ret == SBI_IPI_RETRY);
+	targets = 0;
+	for (mask = hartMask & ~(1UL << self); mask != 0; mask &= ~(1UL << i)) {
+		i = sbi_getFirstBit(mask);
+		if (sbi_ipiIsStarted(i) != 0) {
+			targets |= 1UL << i;
+		}
+	}
 
-			if (ret < 0) {
-				return ret;
+	if (targets != 0) {
+		if (handler != NULL) {
+			/* One shared task for all targets, set the countdown before anyone can see it */
+			task.handler = handler;
+			task.data = data;
+			task.count = __builtin_popcountl(targets);
+
+			for (mask = targets; mask != 0; mask &= ~(1UL << i)) {
+				i = sbi_getFirstBit(mask);
+				sbi_ipiPost(i, self, &task);
 			}
 		}
+
+		/* Raise all MSIPs together */
+		RISCV_FENCE(ow, ow);
+		for (mask = targets; mask != 0; mask &= ~(1UL << i)) {
+			i = sbi_getFirstBit(mask);
+			clint_sendIpi(i);
+		}
+	}
+
+	if (((hartMask & (1UL << self)) != 0) && (handler != NULL)) {
+		handler(data);
+	}
+
+	if ((handler != NULL) && (targets != 0) && (sbi_ipiWait(self, targets, &task) != 0)) {
+		return SBI_ERR_FAILED;
 	}
 
 	return SBI_SUCCESS;
@@ -162,12 +234,7 @@ long sbi_ipiSendMany(unsigned long hartMask, unsigned long hartMaskBase, void (*
 
 void sbi_ipiInit(void)
 {
-	size_t i;
-	for (i = 0; i < sbi_getHartCount(); i++) {
-		spinlock_create(&ipi_common.lock[i], "ipi");
-	}
-
-	sbi_memset(ipi_common.poolMask, 0xff, sizeof(ipi_common.poolMask));
+	sbi_memset(&ipi_common, 0, sizeof(ipi_common));
 
 	RISCV_FENCE(w, rw);
 }
@@ -0,0 +1,485 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Phoenix SBI
+ *
+ * SBI PMU counters
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#include "csr.h"
+#include "fdt.h"
+#include "sbi.h"
+
+#include "extensions/pmu.h"
+
+#include "ld/noelv.ldt"
+
+
+/* Logical counters: 0 - cycle, 1 - time, 2 - instret, 3.. - implemented
+ * mhpmcounters, then firmware counters.
+ */
+#define PMU_HW_MAX   32
+#define PMU_FW_SLOTS 8
+
+#define PMU_CFG_SKIP_MATCH  (1UL << 0)
+#define PMU_CFG_CLEAR_VALUE (1UL << 1)
+#define PMU_CFG_AUTO_START  (1UL << 2)
+
+#define PMU_START_SET_INIT_VALUE (1UL << 0)
+#define PMU_STOP_RESET           (1UL << 0)
+
+#define PMU_INFO_FW (1UL << 63)
+
+#define PMU_CTR_CYCLE   0
+#define PMU_CTR_TIME    1
+#define PMU_CTR_INSTRET 2
+
+
+/* clang-format off */
+#define PMU_HPM_FOREACH(f) \
+	f(3) f(4) f(5) f(6) f(7) f(8) f(9) f(10) f(11) f(12) f(13) f(14) f(15) f(16) f(17) \
+	f(18) f(19) f(20) f(21) f(22) f(23) f(24) f(25) f(26) f(27) f(28) f(29) f(30) f(31)
+
+#define PMU_HPM_CNT_READ(n)   case n: return csr_read(CSR_MHPMCOUNTER3 + (n) - 3);
+#define PMU_HPM_CNT_WRITE(n)  case n: csr_write(CSR_MHPMCOUNTER3 + (n) - 3, val); break;
+#define PMU_HPM_EVT_WRITE(n)  case n: csr_write(CSR_MHPMEVENT3 + (n) - 3, val); break;
+/* clang-format on */
+
+
+typedef struct {
+	u64 used;    /* configured logical counters */
+	u64 running; /* started logical counters */
+	u64 select[PMU_HW_MAX];
+	struct {
+		unsigned int event; /* firmware counter index */
+		u64 value;
+		u64 start;
+	} fw[PMU_FW_SLOTS];
+} pmu_hart_t;
+
+
+static struct {
+	u64 fw[MAX_HART_COUNT][PMU_FW_COUNTERS];
+	pmu_hart_t hart[MAX_HART_COUNT];
+	unsigned int nHw;
+	u8 width[PMU_HW_MAX];
+	pmu_info_t info;
+} pmu_common;
+
+
+void pmu_fwEventAdd(unsigned int idx, u64 val)
+{
+	pmu_common.fw[csr_read(CSR_MHARTID)][idx] += val;
+}
+
+
+u64 pmu_fwEventRead(u32 hartid, unsigned int idx)
+{
+	return *(volatile u64 *)&pmu_common.fw[hartid][idx];
+}
+
+
+static u64 pmu_hpmCounterRead(unsigned int n)
+{
+	switch (n) {
+		PMU_HPM_FOREACH(PMU_HPM_CNT_READ)
+		default:
+			return 0;
+	}
+}
+
+
+static void pmu_hpmCounterWrite(unsigned int n, u64 val)
+{
+	switch (n) {
+		PMU_HPM_FOREACH(PMU_HPM_CNT_WRITE)
+		default:
+			break;
+	}
+}
+
+
+static void pmu_hpmEventWrite(unsigned int n, u64 val)
+{
+	switch (n) {
+		PMU_HPM_FOREACH(PMU_HPM_EVT_WRITE)
+		default:
+			break;
+	}
+}
+
+
+static void pmu_hwCounterWrite(unsigned int n, u64 val)
+{
+	switch (n) {
+		case PMU_CTR_CYCLE:
+			csr_write(CSR_MCYCLE, val);
+			break;
+
+		case PMU_CTR_INSTRET:
+			csr_write(CSR_MINSTRET, val);
+			break;
+
+		case PMU_CTR_TIME:
+			break;
+
+		default:
+			pmu_hpmCounterWrite(n, val);
+			break;
+	}
+}
+
+
+static pmu_hart_t *pmu_hart(void)
+{
+	return &pmu_common.hart[csr_read(CSR_MHARTID)];
+}
+
+
+static unsigned long pmu_counterCount(void)
+{
+	return pmu_common.nHw + PMU_FW_SLOTS;
+}
+
+
+static int pmu_isFw(unsigned long idx)
+{
+	return (idx >= pmu_common.nHw);
+}
+
+
+static u64 pmu_fwCurrent(const pmu_hart_t *hart, unsigned int slot)
+{
+	return pmu_fwEventRead(csr_read(CSR_MHARTID), hart->fw[slot].event);
+}
+
+
+/* Validates counter mask, returns mask of logical counters or 0 if it names a nonexistent counter */
+static u64 pmu_counterMask(unsigned long base, unsigned long mask)
+{
+	unsigned long n = pmu_counterCount();
+
+	if ((base >= n) || (mask == 0)) {
+		return 0;
+	}
+
+	if (((n - base) < (sizeof(mask) * 8)) && ((mask >> (n - base)) != 0)) {
+		return 0;
+	}
+
+	return (u64)mask << base;
+}
+
+
+/* Returns mask of hpm counters able to count event according to FDT */
+static u64 pmu_eventCounters(unsigned long event)
+{
+	unsigned int i;
+	u64 counters = 0;
+
+	for (i = 0; i < pmu_common.info.nCounterMaps; i++) {
+		if ((event >= pmu_common.info.counterMap[i].eventStart) && (event <= pmu_common.info.counterMap[i].eventEnd)) {
+			counters |= pmu_common.info.counterMap[i].counters;
+		}
+	}
+
+	return counters;
+}
+
+
+static int pmu_eventSelect(unsigned long event, u64 data, u64 *select)
+{
+	unsigned int i;
+
+	if (SBI_PMU_EVENT_TYPE(event) == SBI_PMU_EVENT_TYPE_HW_RAW) {
+		*select = data;
+		return 0;
+	}
+
+	for (i = 0; i < pmu_common.info.nEventMaps; i++) {
+		if (pmu_common.info.eventMap[i].event == event) {
+			*select = pmu_common.info.eventMap[i].select;
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+
+static int pmu_fwEventIndex(unsigned long event, u64 data, unsigned int *idx)
+{
+	unsigned long code = SBI_PMU_EVENT_CODE(event);
+
+	if (code < SBI_PMU_FW_MAX) {
+		*idx = code;
+		return 0;
+	}
+
+	if ((code == SBI_PMU_FW_PLATFORM) && (data < PMU_PLAT_MAX)) {
+		*idx = PMU_FW_PLAT(data);
+		return 0;
+	}
+
+	return -1;
+}
+
+
+static u64 pmu_hpmMask(void)
+{
+	return ((1UL << pmu_common.nHw) - 1) & ~((1UL << 3) - 1);
+}
+
+
+unsigned long pmu_numCounters(void)
+{
+	return pmu_counterCount();
+}
+
+
+sbiret_t pmu_counterGetInfo(unsigned long idx)
+{
+	if (idx >= pmu_counterCount()) {
+		return (sbiret_t) { .error = SBI_ERR_INVALID_PARAM };
+	}
+
+	if (pmu_isFw(idx) != 0) {
+		return (sbiret_t) { .error = SBI_SUCCESS, .value = PMU_INFO_FW };
+	}
+
+	/* [11:0] CSR number, [17:12] width - 1 */
+	return (sbiret_t) { .error = SBI_SUCCESS, .value = (CSR_CYCLE + idx) | ((pmu_common.width[idx] - 1UL) << 12) };
+}
+
+
+sbiret_t pmu_counterConfig(unsigned long base, unsigned long mask, unsigned long flags, unsigned long event, u64 data)
+{
+	pmu_hart_t *hart = pmu_hart();
+	u64 candidates = pmu_counterMask(base, mask);
+	u64 select = 0;
+	unsigned int idx, fwIdx = 0;
+	unsigned long type = SBI_PMU_EVENT_TYPE(event);
+
+	if (candidates == 0) {
+		return (sbiret_t) { .error = SBI_ERR_INVALID_PARAM };
+	}
+
+	if ((flags & PMU_CFG_SKIP_MATCH) != 0) {
+		/* Counter already configured by a previous call */
+		idx = sbi_getFirstBit(candidates);
+		if ((hart->used & (1UL << idx)) == 0) {
+			return (sbiret_t) { .error = SBI_ERR_INVALID_PARAM };
+		}
+	}
+	else if (type == SBI_PMU_EVENT_TYPE_FW) {
+		if (pmu_fwEventIndex(event, data, &fwIdx) < 0) {
+			return (sbiret_t) { .error = SBI_ERR_NOT_SUPPORTED };
+		}
+
+		candidates &= ~((1UL << pmu_common.nHw) - 1) & ~hart->used;
+		if (candidates == 0) {
+			return (sbiret_t) { .error = SBI_ERR_NOT_SUPPORTED };
+		}
+
+		idx = sbi_getFirstBit(candidates);
+		hart->fw[idx - pmu_common.nHw].event = fwIdx;
+		hart->fw[idx - pmu_common.nHw].value = 0;
+	}
+	else {
+		if ((type == SBI_PMU_EVENT_TYPE_HW) && (SBI_PMU_EVENT_CODE(event) == SBI_PMU_HW_CPU_CYCLES) &&
+			((candidates & ~hart->used & (1UL << PMU_CTR_CYCLE)) != 0)) {
+			candidates = 1UL << PMU_CTR_CYCLE;
+		}
+		else if ((type == SBI_PMU_EVENT_TYPE_HW) && (SBI_PMU_EVENT_CODE(event) == SBI_PMU_HW_INSTRUCTIONS) &&
+			((candidates & ~hart->used & (1UL << PMU_CTR_INSTRET)) != 0)) {
+			candidates = 1UL << PMU_CTR_INSTRET;
+		}
+		else {
+			if (pmu_eventSelect(event, data, &select) < 0) {
+				return (sbiret_t) { .error = SBI_ERR_NOT_SUPPORTED };
+			}
+
+			candidates &= pmu_hpmMask();
+			if (type != SBI_PMU_EVENT_TYPE_HW_RAW) {
+				candidates &= pmu_eventCounters(event);
+			}
+		}
+
+		candidates &= ~hart->used;
+		if (candidates == 0) {
+			return (sbiret_t) { .error = SBI_ERR_NOT_SUPPORTED };
+		}
+
+		idx = sbi_getFirstBit(candidates);
+		hart->select[idx] = select;
+		if (idx >= 3) {
+			pmu_hpmEventWrite(idx, 0);
+		}
+	}
+
+	hart->used |= 1UL << idx;
+
+	if ((flags & PMU_CFG_CLEAR_VALUE) != 0) {
+		if (pmu_isFw(idx) != 0) {
+			hart->fw[idx - pmu_common.nHw].value = 0;
+		}
+		else {
+			pmu_hwCounterWrite(idx, 0);
+		}
+	}
+
+	if (((flags & PMU_CFG_AUTO_START) != 0) && ((hart->running & (1UL << idx)) == 0)) {
+		pmu_counterStart(idx, 1, 0, 0);
+	}
+
+	return (sbiret_t) { .error = SBI_SUCCESS, .value = idx };
+}
+
+
+long pmu_counterStart(unsigned long base, unsigned long mask, unsigned long flags, u64 value)
+{
+	pmu_hart_t *hart = pmu_hart();
+	u64 ctrs = pmu_counterMask(base, mask);
+	unsigned int idx, slot;
+
+	if ((ctrs == 0) || ((ctrs & ~hart->used) != 0)) {
+		return SBI_ERR_INVALID_PARAM;
+	}
+
+	if ((ctrs & hart->running) != 0) {
+		return SBI_ERR_ALREADY_STARTED;
+	}
+
+	for (; ctrs != 0; ctrs &= ~(1UL << idx)) {
+		idx = sbi_getFirstBit(ctrs);
+
+		if (pmu_isFw(idx) != 0) {
+			slot = idx - pmu_common.nHw;
+			if ((flags & PMU_START_SET_INIT_VALUE) != 0) {
+				hart->fw[slot].value = value;
+			}
+			hart->fw[slot].start = pmu_fwCurrent(hart, slot);
+		}
+		else {
+			if ((flags & PMU_START_SET_INIT_VALUE) != 0) {
+				pmu_hwCounterWrite(idx, value);
+			}
+			/* cycle and instret are free running */
+			if (idx >= 3) {
+				pmu_hpmEventWrite(idx, hart->select[idx]);
+			}
+		}
+
+		hart->running |= 1UL << idx;
+	}
+
+	return SBI_SUCCESS;
+}
+
+
+long pmu_counterStop(unsigned long base, unsigned long mask, unsigned long flags)
+{
+	pmu_hart_t *hart = pmu_hart();
+	u64 ctrs = pmu_counterMask(base, mask);
+	unsigned int idx, slot;
+
+	if ((ctrs == 0) || ((ctrs & ~hart->used) != 0)) {
+		return SBI_ERR_INVALID_PARAM;
+	}
+
+	if (((ctrs & ~hart->running) != 0) && ((flags & PMU_STOP_RESET) == 0)) {
+		return SBI_ERR_ALREADY_STOPPED;
+	}
+
+	for (; ctrs != 0; ctrs &= ~(1UL << idx)) {
+		idx = sbi_getFirstBit(ctrs);
+
+		if ((hart->running & (1UL << idx)) != 0) {
+			if (pmu_isFw(idx) != 0) {
+				slot = idx - pmu_common.nHw;
+				hart->fw[slot].value += pmu_fwCurrent(hart, slot) - hart->fw[slot].start;
+			}
+			else if (idx >= 3) {
+				pmu_hpmEventWrite(idx, 0);
+			}
+			hart->running &= ~(1UL << idx);
+		}
+
+		if ((flags & PMU_STOP_RESET) != 0) {
+			hart->used &= ~(1UL << idx);
+		}
+	}
+
+	return SBI_SUCCESS;
+}
+
+
+sbiret_t pmu_counterFwRead(unsigned long idx)
+{
+	pmu_hart_t *hart = pmu_hart();
+	unsigned int slot;
+	u64 value;
+
+	if ((idx >= pmu_counterCount()) || (pmu_isFw(idx) == 0) || ((hart->used & (1UL << idx)) == 0)) {
+		return (sbiret_t) { .error = SBI_ERR_INVALID_PARAM };
+	}
+
+	slot = idx - pmu_common.nHw;
+	value = hart->fw[slot].value;
+	if ((hart->running & (1UL << idx)) != 0) {
+		value += pmu_fwCurrent(hart, slot) - hart->fw[slot].start;
+	}
+
+	return (sbiret_t) { .error = SBI_SUCCESS, .value = value };
+}
+
+
+void pmu_hartInit(void)
+{
+	unsigned int n;
+
+	for (n = 3; n < pmu_common.nHw; n++) {
+		pmu_hpmEventWrite(n, 0);
+	}
+
+	/* Let S-mode read cycle, time, instret and all implemented hpm counters */
+	csr_write(CSR_MCOUNTEREN, (1UL << pmu_common.nHw) - 1);
+}
+
+
+void pmu_init(void)
+{
+	unsigned int n;
+	u64 v;
+
+	pmu_common.width[PMU_CTR_CYCLE] = 64;
+	pmu_common.width[PMU_CTR_TIME] = 64;
+	pmu_common.width[PMU_CTR_INSTRET] = 64;
+
+	/* Unimplemented mhpmcounters are hardwired to zero, implemented ones
+	 * don't count with mhpmevent cleared. Assumes they're contiguous.
+	 */
+	for (n = 3; n < PMU_HW_MAX; n++) {
+		pmu_hpmEventWrite(n, 0);
+		pmu_hpmCounterWrite(n, (u64)-1);
+		v = pmu_hpmCounterRead(n);
+		pmu_hpmCounterWrite(n, 0);
+		if (v == 0) {
+			break;
+		}
+		pmu_common.width[n] = 64 - __builtin_clzll(v);
+	}
+	pmu_common.nHw = n;
+
+	if (fdt_getPmuInfo(&pmu_common.info) < 0) {
+		/* Only cycle, instret and raw events then */
+		pmu_common.info.nCounterMaps = 0;
+		pmu_common.info.nEventMaps = 0;
+	}
+}
@@ -83,6 +83,88 @@ int fdt_parseCpus(void)
 }
 
 
+/* Checks "riscv,isa" string, multi-letter extensions follow base ISA separated by '_' */
+static int fdt_isaStrHasExt(const char *isa, size_t len, const char *ext)
+{
+	const char *end = isa + len;
+	const char *tok;
+	size_t extLen = sbi_strlen(ext);
+
+	while ((isa < end) && (*isa != '\0') && (*isa != '_')) {
+		isa++;
+	}
+
+	while ((isa < end) && (*isa == '_')) {
+		tok = ++isa;
+		while ((isa < end) && (*isa != '\0') && (*isa != '_')) {
+			isa++;
+		}
+
+		if (((size_t)(isa - tok) == extLen) && (sbi_strncmp(tok, ext, extLen) == 0)) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+
+/* Checks "riscv,isa-extensions" string list */
+static int fdt_isaListHasExt(const char *list, size_t len, const char *ext)
+{
+	const char *end = list + len;
+
+	while (list < end) {
+		if (sbi_strcmp(list, ext) == 0) {
+			return 1;
+		}
+		list += sbi_strlen(list) + 1;
+	}
+
+	return 0;
+}
+
+
+int fdt_cpusHaveIsaExt(const char *ext)
+{
+	int cpus = 0;
+	int depth = -1;
+	int has;
+	fdt_prop_t *prop;
+
+	ssize_t offset = fdt_findNodeByName(0, &depth, "cpus", 4, 1);
+	if (offset < 0) {
+		return 0;
+	}
+
+	for (;;) {
+		offset = fdt_findInCurrentNode(offset, &depth, "cpu@", 4, 2);
+		if (offset < 0) {
+			break;
+		}
+
+		prop = fdt_getProperty(offset, "riscv,isa-extensions");
+		if (prop != NULL) {
+			has = fdt_isaListHasExt((const char *)prop->data, fdt32_to_cpu(prop->len), ext);
+		}
+		else {
+			prop = fdt_getProperty(offset, "riscv,isa");
+			if (prop == NULL) {
+				return 0;
+			}
+			has = fdt_isaStrHasExt((const char *)prop->data, fdt32_to_cpu(prop->len), ext);
+		}
+
+		if (has == 0) {
+			return 0;
+		}
+		cpus++;
+	}
+
+	return (cpus > 0) ? 1 : 0;
+}
+
+
 /* Get #address-cells and #size-cells from node */
 static ssize_t fdt_getPeripheralAddressCells(ssize_t offset, int *depth, fdt_cellInfo_t *info, const char *node)
 {
@@ -223,3 +305,44 @@ int fdt_getClintInfo(clint_info_t *clint)
 
 	return FDT_EOK;
 }
+
+
+int fdt_getPmuInfo(pmu_info_t *pmu)
+{
+	ssize_t offset;
+	int depth = -1;
+	fdt_prop_t *prop;
+	unsigned int i, n;
+
+	offset = fdt_findNodeByCompatible(0, &depth, "riscv,pmu");
+	if (offset < 0) {
+		return offset;
+	}
+
+	pmu->nEventMaps = 0;
+	prop = fdt_getProperty(offset, "riscv,event-to-mhpmevent");
+	if (prop != NULL) {
+		/* <event_idx mhpmevent_hi mhpmevent_lo> */
+		n = fdt32_to_cpu(prop->len) / (3 * sizeof(u32));
+		for (i = 0; (i < n) && (i < PMU_MAP_MAX); i++) {
+			pmu->eventMap[i].event = fdt32_to_cpu(prop->data[3 * i]);
+			pmu->eventMap[i].select = ((u64)fdt32_to_cpu(prop->data[3 * i + 1]) << 32) | fdt32_to_cpu(prop->data[3 * i + 2]);
+		}
+		pmu->nEventMaps = i;
+	}
+
+	pmu->nCounterMaps = 0;
+	prop = fdt_getProperty(offset, "riscv,event-to-mhpmcounters");
+	if (prop != NULL) {
+		/* <event_idx_start event_idx_end counter_bitmap> */
+		n = fdt32_to_cpu(prop->len) / (3 * sizeof(u32));
+		for (i = 0; (i < n) && (i < PMU_MAP_MAX); i++) {
+			pmu->counterMap[i].eventStart = fdt32_to_cpu(prop->data[3 * i]);
+			pmu->counterMap[i].eventEnd = fdt32_to_cpu(prop->data[3 * i + 1]);
+			pmu->counterMap[i].counters = fdt32_to_cpu(prop->data[3 * i + 2]);
+		}
+		pmu->nCounterMaps = i;
+	}
+
+	return FDT_EOK;
+}
@@ -14,8 +14,16 @@
  */
 
 #include "csr.h"
+#include "fdt.h"
 #include "hart.h"
 
+#include "extensions/pmu.h"
+
+
+static struct {
+	int sstc;
+} hart_common;
+
 
 void __attribute__((noreturn)) hart_halt(void)
 {
@@ -54,10 +62,23 @@ void __attribute__((noreturn)) hart_changeMode(sbi_param arg0, sbi_param arg1, a
 }
 
 
+/* Must be called by the boot hart once FDT is available, before other harts are started */
+void hart_detectFeatures(void)
+{
+	hart_common.sstc = fdt_cpusHaveIsaExt("sstc");
+}
+
+
+int hart_hasSstc(void)
+{
+	return hart_common.sstc;
+}
+
+
 void hart_init(void)
 {
 	/* Enable counters for supervisor */
-	csr_write(CSR_MCOUNTEREN, -1);
+	pmu_hartInit();
 
 	/* Enable IR, TM, CY counters for user */
 	csr_write(CSR_SCOUNTEREN, 0x7);
@@ -70,6 +91,11 @@ void hart_init(void)
 	 */
 	csr_write(CSR_MEDELEG, 0xb1fb);
 
+	if (hart_common.sstc != 0) {
+		/* Let S-mode program its timer directly through stimecmp */
+		csr_set(CSR_MENVCFG, MENVCFG_STCE);
+	}
+
 	/* Enable IPI */
 	csr_set(CSR_MIE, MIP_MSIP);
 }
@@ -18,12 +18,14 @@
 #include "fdt.h"
 #include "hart.h"
 #include "sbi.h"
+#include "spinlock.h"
 
 #include "devices/clint.h"
 #include "devices/console.h"
 
 #include "extensions/hsm.h"
 #include "extensions/ipi.h"
+#include "extensions/pmu.h"
 
 #include "ld/noelv.ldt"
 
@@ -34,12 +36,17 @@ extern const sbi_ext_t __ext_start[];
 extern const sbi_ext_t __ext_end[];
 
 
+/* Power of 2, kept at least twice the number of extensions to keep probe chains short */
+#define SBI_EXT_HASH_SIZE 32
+
+
 volatile u64 sbi_hartMask;
 
 
 static struct {
 	volatile u32 hartCount;
 	sbi_perHartData_t perHartData[MAX_HART_COUNT] __attribute__((aligned(8)));
+	const sbi_ext_t *extHash[SBI_EXT_HASH_SIZE];
 } sbi_common;
 
 
@@ -79,23 +86,58 @@ unsigned int sbi_getFirstBit(unsigned long v)
 }
 
 
-sbiret_t sbi_dispatchEcall(sbi_param a0, sbi_param a1, sbi_param a2, sbi_param a3, sbi_param a4, sbi_param a5, int fid, int eid)
+static inline unsigned int sbi_extHash(unsigned long eid)
 {
-	const sbi_ext_t *ext;
+	/* EIDs are mostly ASCII tags, fold all bytes into the index */
+	eid ^= eid >> 16;
+	eid ^= eid >> 8;
+
+	return eid & (SBI_EXT_HASH_SIZE - 1);
+}
 
-	sbiret_t ret = {
-		.error = SBI_ERR_NOT_SUPPORTED,
-		.value = 0
-	};
+
+static void sbi_extInit(void)
+{
+	const sbi_ext_t *ext;
+	unsigned int idx;
 
 	for (ext = __ext_start; ext < __ext_end; ext++) {
+		idx = sbi_extHash(ext->eid);
+		while (sbi_common.extHash[idx] != NULL) {
+			idx = (idx + 1) & (SBI_EXT_HASH_SIZE - 1);
+		}
+		sbi_common.extHash[idx] = ext;
+	}
+}
+
+
+const sbi_ext_t *sbi_getExtension(long eid)
+{
+	const sbi_ext_t *ext;
+	unsigned int idx = sbi_extHash(eid);
+
+	while ((ext = sbi_common.extHash[idx]) != NULL) {
 		if (ext->eid == eid) {
-			ret = ext->handler(a0, a1, a2, a3, a4, a5, fid);
-			break;
+			return ext;
 		}
+		idx = (idx + 1) & (SBI_EXT_HASH_SIZE - 1);
+	}
+
+	return NULL;
+}
+
+
+sbiret_t sbi_dispatchEcall(sbi_param a0, sbi_param a1, sbi_param a2, sbi_param a3, sbi_param a4, sbi_param a5, int fid, int eid)
+{
+	const sbi_ext_t *ext = sbi_getExtension(eid);
+
+	pmu_fwEventAdd(PMU_FW_PLAT(PMU_PLAT_ECALLS), 1);
+
+	if (ext == NULL) {
+		return (sbiret_t) { .error = SBI_ERR_NOT_SUPPORTED, .value = 0 };
 	}
 
-	return ret;
+	return ext->handler(a0, a1, a2, a3, a4, a5, fid);
 }
 
 
@@ -126,8 +168,15 @@ void sbi_scratchInit(u32 hartid, const void *fdt, addr_t sp)
 void __attribute__((noreturn)) sbi_initCold(u32 hartid, const void *fdt)
 {
 	fdt_init(fdt);
+	sbi_extInit();
 
 	sbi_common.hartCount = fdt_parseCpus();
+	hart_detectFeatures();
+	pmu_init();
+
+#ifdef SBI_SPINLOCK_TEST
+	spinlock_testRun(hartid);
+#endif
 
 	hsm_init(hartid);
 
@@ -138,12 +187,20 @@ void __attribute__((noreturn)) sbi_initCold(u32 hartid, const void *fdt)
 
 	console_print("Phoenix SBI\n");
 
+#ifdef SBI_SPINLOCK_TEST
+	spinlock_testReport();
+#endif
+
 	hsm_hartStartJump(hartid);
 }
 
 
 void __attribute__((noreturn)) sbi_initWarm(u32 hartid)
 {
+#ifdef SBI_SPINLOCK_TEST
+	spinlock_testRun(hartid);
+#endif
+
 	hsm_init(hartid);
 
 	hart_init();
@@ -0,0 +1,118 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Phoenix SBI
+ *
+ * Spinlock contention stress test
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#include "atomic.h"
+#include "csr.h"
+#include "sbi.h"
+#include "spinlock.h"
+#include "string.h"
+
+#include "devices/console.h"
+
+#include "ld/noelv.ldt"
+
+
+/* Total number of lock acquisitions shared by all harts */
+#ifndef SPINLOCK_TEST_ACQUIRES
+#define SPINLOCK_TEST_ACQUIRES 100000
+#endif
+
+
+static struct {
+	spinlock_t lock;
+	volatile u32 arrived;
+	volatile u32 finished;
+	volatile u64 shared; /* protected by lock */
+	u64 count[MAX_HART_COUNT];
+	u64 maxWait[MAX_HART_COUNT]; /* longest acquisition in cycles */
+	u64 cycles[MAX_HART_COUNT];
+} spinlock_test;
+
+
+/* Runs on every hart before HSM init, the lock is valid zeroed with .bss */
+void spinlock_testRun(u32 hartid)
+{
+	spinlock_ctx_t sc;
+	u64 start, t0, wait, cnt = 0, maxWait = 0;
+	u32 n;
+
+	/* Hart count is parsed from FDT by the boot hart */
+	while ((n = sbi_getHartCount()) == 0) {
+	}
+
+	/* All harts start contending at once */
+	atomic_add32(&spinlock_test.arrived, 1);
+	while (ATOMIC_READ(&spinlock_test.arrived) < n) {
+	}
+
+	start = csr_read(CSR_MCYCLE);
+	for (;;) {
+		t0 = csr_read(CSR_MCYCLE);
+		spinlock_set(&spinlock_test.lock, &sc);
+		wait = csr_read(CSR_MCYCLE) - t0;
+
+		if (spinlock_test.shared >= SPINLOCK_TEST_ACQUIRES) {
+			spinlock_clear(&spinlock_test.lock, &sc);
+			break;
+		}
+		spinlock_test.shared++;
+		spinlock_clear(&spinlock_test.lock, &sc);
+
+		cnt++;
+		if (wait > maxWait) {
+			maxWait = wait;
+		}
+	}
+
+	spinlock_test.cycles[hartid] = csr_read(CSR_MCYCLE) - start;
+	spinlock_test.count[hartid] = cnt;
+	spinlock_test.maxWait[hartid] = maxWait;
+
+	RISCV_FENCE(w, w);
+	atomic_add32(&spinlock_test.finished, 1);
+}
+
+
+/* Prints acquisitions and the longest wait per hart, fairness (min/max share) and throughput */
+void spinlock_testReport(void)
+{
+	char buff[128];
+	u32 i, n = sbi_getHartCount();
+	u64 minCnt = (u64)-1, maxCnt = 0, cycles = 0;
+	int len;
+
+	while (ATOMIC_READ(&spinlock_test.finished) < n) {
+	}
+
+	console_print("spinlock test:\n");
+	for (i = 0; i < n; i++) {
+		len = sbi_i2s(" hart ", buff, i, 10, 0);
+		len += sbi_i2s(" acquires ", &buff[len], spinlock_test.count[i], 10, 0);
+		len += sbi_i2s(" max wait ", &buff[len], spinlock_test.maxWait[i], 10, 0);
+		len += sbi_i2s(" cycles ", &buff[len], spinlock_test.cycles[i], 10, 0);
+		buff[len++] = '\n';
+		buff[len] = '\0';
+		console_print(buff);
+
+		minCnt = (spinlock_test.count[i] < minCnt) ? spinlock_test.count[i] : minCnt;
+		maxCnt = (spinlock_test.count[i] > maxCnt) ? spinlock_test.count[i] : maxCnt;
+		cycles = (spinlock_test.cycles[i] > cycles) ? spinlock_test.cycles[i] : cycles;
+	}
+
+	len = sbi_i2s(" fairness % ", buff, (maxCnt != 0) ? (minCnt * 100) / maxCnt : 0, 10, 0);
+	len += sbi_i2s(" acquires per 1000 cycles ", &buff[len], (cycles != 0) ? ((u64)SPINLOCK_TEST_ACQUIRES * 1000) / cycles : 0, 10, 0);
+	buff[len++] = '\n';
+	buff[len] = '\0';
+	console_print(buff);
+}
@@ -13,39 +13,61 @@
  * %LICENSE%
  */
 
+#include "csr.h"
 #include "spinlock.h"
 
 
+/* Upper bound of pause hints between polls of a contended lock */
+#ifndef SPINLOCK_BACKOFF_MAX
+#define SPINLOCK_BACKOFF_MAX 256
+#endif
+
+
+static inline void spinlock_pause(void)
+{
+	/* Zihintpause pause, encoded as a fence hint - harmless on harts without it */
+	__asm__ volatile(".4byte 0x0100000f" ::: "memory");
+}
+
+
 void spinlock_set(spinlock_t *spinlock, spinlock_ctx_t *sc)
 {
+	u32 ticket, i, delay = 1;
+
 	/* clang-format off */
 	__asm__ volatile (
-		"csrrc t0, sstatus, (1 << 3)\n\t"
-		"sd t0, (%0)\n\t"
-		"li t0, 1\n\t"
-	"1:\n\t"
-		"amoswap.w.aq t0, t0, %1\n\t"
-		"bnez t0, 1b\n\t"
-		"fence r, rw"
-	:
-	: "r" (sc), "A" (spinlock->lock)
-	: "t0", "memory");
+		"csrrc %0, mstatus, %2\n\t"
+		"amoadd.w.aq %1, %3, %4"
+	: "=&r" (*sc), "=&r" (ticket)
+	: "r" (MSTATUS_MIE), "r" (1U << 16), "A" (spinlock->lock)
+	: "memory");
 	/* clang-format on */
+
+	ticket >>= 16;
+
+	while (spinlock->ticket.owner != (u16)ticket) {
+		/* Exponential backoff keeps waiters off the lock's cache line */
+		for (i = 0; i < delay; i++) {
+			spinlock_pause();
+		}
+
+		if (delay < SPINLOCK_BACKOFF_MAX) {
+			delay <<= 1;
+		}
+	}
+
+	__asm__ volatile("fence r, rw" ::: "memory");
 }
 
 
 void spinlock_clear(spinlock_t *spinlock, spinlock_ctx_t *sc)
 {
-	/* clang-format off */
-	__asm__ volatile (
-		"fence rw, w\n\t"
-		"amoswap.w.rl zero, zero, %0\n\t"
-		"ld t0, (%1)\n\t"
-		"csrw sstatus, t0"
-	:
-	: "A" (spinlock->lock), "r" (sc)
-	: "t0", "memory");
-	/* clang-format on */
+	u16 next = spinlock->ticket.owner + 1;
+
+	__asm__ volatile("fence rw, w" ::: "memory");
+	spinlock->ticket.owner = next;
+
+	csr_set(CSR_MSTATUS, *sc & MSTATUS_MIE);
 }
 
 
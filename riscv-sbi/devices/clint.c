@@ -16,6 +16,8 @@
 
 #include "csr.h"
 #include "fdt.h"
+#include "hart.h"
+#include "sbi.h"
 #include "types.h"
 
 #include "devices/clint.h"
@@ -74,9 +76,21 @@ u64 clint_getTime(void)
 void clint_init(void)
 {
 	clint_info_t info;
+	sbi_perHartData_t *data;
+	u32 hartid;
 
 	if (fdt_getClintInfo(&info) < 0) {
 		return;
 	}
 	clint_common.base = info.reg.base;
+
+	/* Let the trap entry program timers and emulate rdtime without calling into C.
+	 * With Sstc set_timer goes to stimecmp, leave it to the C handler.
+	 */
+	for (hartid = 0; hartid < sbi_getHartCount(); hartid++) {
+		data = sbi_getPerHartData(hartid);
+		data->timecmp = (hart_hasSstc() != 0) ? 0 : (clint_common.base + CLINT_MTIMECMP(hartid));
+		data->mtime = clint_common.base + CLINT_MTIMER;
+	}
+	RISCV_FENCE(w, rw);
 }
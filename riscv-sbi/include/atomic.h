@@ -69,6 +69,70 @@ static inline void atomic_add64(vu64 *ptr, u64 val)
 }
 
 
+static inline u64 atomic_fetchAdd64(vu64 *ptr, u64 val)
+{
+	u64 prev;
+
+	/* clang-format off */
+	__asm__ volatile (
+		"amoadd.d.aqrl %0, %2, (%1)"
+		: "=r" (prev), "+r" (ptr)
+		: "r" (val)
+		: "memory"
+	);
+	/* clang-format on */
+
+	return prev;
+}
+
+
+static inline u64 atomic_swap64(vu64 *ptr, u64 val)
+{
+	u64 prev;
+
+	/* clang-format off */
+	__asm__ volatile (
+		"amoswap.d.aqrl %0, %2, (%1)"
+		: "=r" (prev), "+r" (ptr)
+		: "r" (val)
+		: "memory"
+	);
+	/* clang-format on */
+
+	return prev;
+}
+
+
+static inline u64 atomic_fetchAnd64(vu64 *ptr, u64 val)
+{
+	u64 prev;
+
+	/* clang-format off */
+	__asm__ volatile (
+		"amoand.d.aqrl %0, %2, (%1)"
+		: "=r" (prev), "+r" (ptr)
+		: "r" (val)
+		: "memory"
+	);
+	/* clang-format on */
+
+	return prev;
+}
+
+
+static inline void atomic_or64(vu64 *ptr, u64 val)
+{
+	/* clang-format off */
+	__asm__ volatile (
+		"amoor.d.aqrl zero, %1, (%0)"
+		: "+r" (ptr)
+		: "r" (val)
+		: "memory"
+	);
+	/* clang-format on */
+}
+
+
 #define ATOMIC_READ(ptr) ({ \
 	typeof(*ptr) ret = *ptr; \
 	RISCV_FENCE(ir, ir); \
@@ -101,6 +101,7 @@ int csr_emulateWrite(u32 csr, u64 val);
 #define CSR_SIE        0x104u
 #define CSR_STVEC      0x105u
 #define CSR_SCOUNTEREN 0x106u
+#define CSR_STIMECMP   0x14du
 #define CSR_SSCRATCH   0x140u
 #define CSR_SATP       0x180u
 
@@ -127,8 +128,10 @@ int csr_emulateWrite(u32 csr, u64 val);
 #define CSR_MIP      0x344u
 #define CSR_MTINST   0x34au
 
-#define CSR_MCYCLE   0xb00u
-#define CSR_MINSTRET 0xb02u
+#define CSR_MCYCLE       0xb00u
+#define CSR_MINSTRET     0xb02u
+#define CSR_MHPMCOUNTER3 0xb03u
+#define CSR_MHPMEVENT3   0x323u
 
 #define CSR_MVENDORID 0xf11u
 #define CSR_MARCHID   0xf12u
@@ -153,6 +156,8 @@ int csr_emulateWrite(u32 csr, u64 val);
 
 #define MIE_MSIE (1UL << 3)
 
+#define MENVCFG_STCE (1UL << 63)
+
 #define MIP_SSIP (1UL << IRQ_S_SOFT)
 #define MIP_MSIP (1UL << IRQ_M_SOFT)
 #define MIP_STIP (1UL << IRQ_S_TIMER)
@@ -21,9 +21,14 @@
 #include "types.h"
 
 
+/* hartMaskBase value selecting all harts */
+#define SBI_HARTMASK_ALL ((unsigned long)-1)
+
+
 typedef struct {
 	void (*handler)(void *);
 	void *data;
+	volatile u32 count; /* number of harts yet to run the handler */
 } ipi_task_t;
 
 
@@ -0,0 +1,123 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Phoenix SBI
+ *
+ * SBI PMU firmware counters
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#ifndef _SBI_EXT_PMU_H_
+#define _SBI_EXT_PMU_H_
+
+
+#include "sbi.h"
+#include "types.h"
+
+
+/* Firmware events (SBI PMU event type 15) */
+#define SBI_PMU_FW_MISALIGNED_LOAD          0
+#define SBI_PMU_FW_MISALIGNED_STORE         1
+#define SBI_PMU_FW_ACCESS_LOAD              2
+#define SBI_PMU_FW_ACCESS_STORE             3
+#define SBI_PMU_FW_ILLEGAL_INSN             4
+#define SBI_PMU_FW_SET_TIMER                5
+#define SBI_PMU_FW_IPI_SENT                 6
+#define SBI_PMU_FW_IPI_RECEIVED             7
+#define SBI_PMU_FW_FENCE_I_SENT             8
+#define SBI_PMU_FW_FENCE_I_RECEIVED         9
+#define SBI_PMU_FW_SFENCE_VMA_SENT          10
+#define SBI_PMU_FW_SFENCE_VMA_RECEIVED      11
+#define SBI_PMU_FW_SFENCE_VMA_ASID_SENT     12
+#define SBI_PMU_FW_SFENCE_VMA_ASID_RECEIVED 13
+#define SBI_PMU_FW_MAX                      22
+#define SBI_PMU_FW_PLATFORM                 0xffff
+
+/* Platform firmware events (SBI_PMU_FW_PLATFORM, selected by event_data) */
+#define PMU_PLAT_RFENCE_PAGES     0 /* sfence.vma issued for page ranges */
+#define PMU_PLAT_RFENCE_FLUSHALL  1 /* full or per-ASID flushes */
+#define PMU_PLAT_RFENCE_COALESCED 2 /* requests covered by an earlier full flush */
+#define PMU_PLAT_ECALLS           3 /* ecalls handled in C */
+#define PMU_PLAT_MAX              4
+
+/* Index of a firmware counter */
+#define PMU_FW_PLAT(n)  (SBI_PMU_FW_MAX + (n))
+#define PMU_FW_COUNTERS PMU_FW_PLAT(PMU_PLAT_MAX)
+
+/* Event index: type [19:16], code [15:0] */
+#define SBI_PMU_EVENT_TYPE(idx) (((idx) >> 16) & 0xf)
+#define SBI_PMU_EVENT_CODE(idx) ((idx) & 0xffff)
+
+#define SBI_PMU_EVENT_TYPE_HW       0
+#define SBI_PMU_EVENT_TYPE_HW_CACHE 1
+#define SBI_PMU_EVENT_TYPE_HW_RAW   2
+#define SBI_PMU_EVENT_TYPE_FW       15
+
+#define SBI_PMU_HW_CPU_CYCLES   1
+#define SBI_PMU_HW_INSTRUCTIONS 2
+
+/* Entries taken from FDT "riscv,pmu" node */
+#define PMU_MAP_MAX 16
+
+
+typedef struct {
+	u32 eventStart;
+	u32 eventEnd;
+	u32 counters; /* mask of hpm counters able to count events in range */
+} pmu_counterMap_t;
+
+
+typedef struct {
+	u32 event;
+	u64 select; /* mhpmevent value */
+} pmu_eventMap_t;
+
+
+typedef struct {
+	unsigned int nCounterMaps;
+	unsigned int nEventMaps;
+	pmu_counterMap_t counterMap[PMU_MAP_MAX];
+	pmu_eventMap_t eventMap[PMU_MAP_MAX];
+} pmu_info_t;
+
+
+/* Counters are per hart, updated by the hart itself */
+void pmu_fwEventAdd(unsigned int idx, u64 val);
+
+
+u64 pmu_fwEventRead(u32 hartid, unsigned int idx);
+
+
+/* Counter management, operates on the calling hart's counters */
+unsigned long pmu_numCounters(void);
+
+
+sbiret_t pmu_counterGetInfo(unsigned long idx);
+
+
+sbiret_t pmu_counterConfig(unsigned long base, unsigned long mask, unsigned long flags, unsigned long event, u64 data);
+
+
+long pmu_counterStart(unsigned long base, unsigned long mask, unsigned long flags, u64 value);
+
+
+long pmu_counterStop(unsigned long base, unsigned long mask, unsigned long flags);
+
+
+sbiret_t pmu_counterFwRead(unsigned long idx);
+
+
+/* Sets up hart's counters and mcounteren */
+void pmu_hartInit(void);
+
+
+/* Called by the boot hart once FDT is available */
+void pmu_init(void);
+
+
+#endif
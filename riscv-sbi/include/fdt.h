@@ -19,17 +19,25 @@
 
 #include "devices/clint.h"
 #include "devices/console.h"
+#include "extensions/pmu.h"
 
 
 int fdt_parseCpus(void);
 
 
+/* Returns 1 if all harts advertise multi-letter ISA extension 'ext' */
+int fdt_cpusHaveIsaExt(const char *ext);
+
+
 int fdt_getUartInfo(uart_info_t *uart, const char *compatible);
 
 
 int fdt_getClintInfo(clint_info_t *clint);
 
 
+int fdt_getPmuInfo(pmu_info_t *pmu);
+
+
 void fdt_init(const void *fdt);
 
 
@@ -61,6 +61,12 @@ void __attribute__((noreturn)) hart_halt(void);
 void __attribute__((noreturn)) hart_changeMode(sbi_param ar0, sbi_param arg1, addr_t nextAddr, sbi_param nextMode);
 
 
+void hart_detectFeatures(void);
+
+
+int hart_hasSstc(void);
+
+
 void hart_init(void);
 
 
@@ -38,6 +38,7 @@
 #define SBI_EXT_IPI    0x735049
 #define SBI_EXT_RFENCE 0x52464E43
 #define SBI_EXT_HSM    0x48534D
+#define SBI_EXT_PMU    0x504D55
 
 
 /* HSM extension: Hart states */
@@ -50,7 +51,14 @@
 #define SBI_HSM_RESUME_PENDING  6
 
 
-#define SIZEOF_SBI_PERHARTDATA 40
+#define SIZEOF_SBI_PERHARTDATA 64
+
+/* Offsets of sbi_perHartData_t fields used by trap entry code */
+#define SBI_PERHART_MSTACK   0
+#define SBI_PERHART_SCRATCH  8
+#define SBI_PERHART_TIMECMP  40
+#define SBI_PERHART_MTIME    48
+#define SBI_PERHART_SCRATCH2 56
 
 #define PAGE_SIZE 0x1000
 
@@ -82,10 +90,17 @@ typedef struct {
 	volatile addr_t state;    /* current hart state */
 	volatile addr_t nextArg1; /* 'a1' register for next boot stage */
 	volatile addr_t nextAddr; /* address of next boot stage */
+	addr_t timecmp;           /* address of hart's mtimecmp register (ecall fast path) */
+	addr_t mtime;             /* address of mtime register (rdtime fast path) */
+	addr_t scratch2;          /* temporary storage */
 } __attribute__((packed, aligned(8))) sbi_perHartData_t;
 
 
 _Static_assert(sizeof(sbi_perHartData_t) == SIZEOF_SBI_PERHARTDATA, "sbi_perHartData_t size changed, update SIZEOF_SBI_PERHARTDATA");
+_Static_assert(__builtin_offsetof(sbi_perHartData_t, scratch) == SBI_PERHART_SCRATCH, "sbi_perHartData_t layout changed, update SBI_PERHART_SCRATCH");
+_Static_assert(__builtin_offsetof(sbi_perHartData_t, timecmp) == SBI_PERHART_TIMECMP, "sbi_perHartData_t layout changed, update SBI_PERHART_TIMECMP");
+_Static_assert(__builtin_offsetof(sbi_perHartData_t, mtime) == SBI_PERHART_MTIME, "sbi_perHartData_t layout changed, update SBI_PERHART_MTIME");
+_Static_assert(__builtin_offsetof(sbi_perHartData_t, scratch2) == SBI_PERHART_SCRATCH2, "sbi_perHartData_t layout changed, update SBI_PERHART_SCRATCH2");
 
 
 extern volatile u64 sbi_hartMask;
@@ -97,6 +112,9 @@ unsigned int sbi_getFirstBit(unsigned long v);
 sbi_perHartData_t *sbi_getPerHartData(u32 hartid);
 
 
+const sbi_ext_t *sbi_getExtension(long eid);
+
+
 u32 sbi_getHartCount(void);
 
 
@@ -22,9 +22,16 @@
 
 typedef u64 spinlock_ctx_t;
 
+/* Ticket lock, harts are served in arrival order */
 typedef struct _spinlock_t {
 	const char *name;
-	u32 lock;
+	union {
+		volatile u32 lock;
+		struct {
+			volatile u16 owner; /* ticket being served */
+			volatile u16 next;  /* next ticket to hand out */
+		} ticket;
+	};
 } spinlock_t;
 
 
@@ -37,4 +44,16 @@ void spinlock_clear(spinlock_t *spinlock, spinlock_ctx_t *sc);
 void spinlock_create(spinlock_t *spinlock, const char *name);
 
 
+#ifdef SBI_SPINLOCK_TEST
+
+/* Contends on a test lock together with all other harts, called on every hart during boot */
+void spinlock_testRun(u32 hartid);
+
+
+/* Waits for all harts to finish the test and prints its results */
+void spinlock_testReport(void);
+
+#endif
+
+
 #endif
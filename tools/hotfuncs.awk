@@ -0,0 +1,115 @@
+#
+# Phoenix-RTOS
+#
+# Operating system loader
+#
+# Hot function list for profile-guided placement in RAM (PLO_HOT_FUNCS)
+#
+# Input: `nm -n -S` symbol table of the profiled image followed by profile lines
+# "<pc>[, ...], <count>" (hex pc, comma or space separated, e.g. QEMU hotblocks
+# plugin output or raw PC samples without count). Functions are printed by
+# decreasing sample count while their total size fits in budget bytes.
+# Functions matching exclude are never selected, startup code runs from its
+# load address before _startc copies the selected functions to RAM.
+#
+# Copyright 2026 Phoenix Systems
+#
+# %LICENSE%
+#
+
+function hex(s,   i, c, v)
+{
+	sub(/^0[xX]/, "", s)
+	v = 0
+	for (i = 1; i <= length(s); i++) {
+		c = index("0123456789abcdef", tolower(substr(s, i, 1)))
+		if (c == 0) {
+			break
+		}
+		v = v * 16 + c - 1
+	}
+
+	return v
+}
+
+
+# Returns index of function containing addr, 0 if none
+function lookup(addr,   lo, hi, mid)
+{
+	lo = 1
+	hi = nsym
+	while (lo <= hi) {
+		mid = int((lo + hi) / 2)
+		if (addr < start[mid]) {
+			hi = mid - 1
+		}
+		else if (addr >= start[mid] + size[mid]) {
+			lo = mid + 1
+		}
+		else {
+			return mid
+		}
+	}
+
+	return 0
+}
+
+
+BEGIN {
+	if (budget == "") {
+		budget = 4096
+	}
+
+	if (exclude == "") {
+		exclude = "^(_start|_startc|_init_vectors|_fcfb|memcpy)$"
+	}
+}
+
+
+# Symbol table, text symbols with size only
+FNR == NR {
+	if ((NF == 4) && ($3 ~ /^[tTwW]$/) && ($4 !~ exclude)) {
+		nsym++
+		start[nsym] = hex($1)
+		size[nsym] = hex($2)
+		name[nsym] = $4
+	}
+	next
+}
+
+
+# Profile, header and malformed lines are skipped
+{
+	gsub(/,/, " ")
+	if ((NF == 0) || ($1 !~ /^(0[xX])?[0-9a-fA-F]+$/)) {
+		next
+	}
+
+	i = lookup(hex($1))
+	if (i != 0) {
+		count[i] += (NF > 1) ? $NF : 1
+	}
+}
+
+
+END {
+	total = 0
+	for (;;) {
+		best = 0
+		for (i in count) {
+			if ((best == 0) || (count[i] > count[best])) {
+				best = i
+			}
+		}
+
+		if (best == 0) {
+			break
+		}
+
+		if (total + size[best] <= budget) {
+			total += size[best]
+			printf "%s # samples %d, size %d\n", name[best], count[best], size[best]
+		}
+		delete count[best]
+	}
+}
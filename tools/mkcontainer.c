@@ -0,0 +1,342 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Operating system loader
+ *
+ * Host tool packing apps and blobs into a container loaded by the container command
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <unistd.h>
+
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+
+#include <cmds/container.h>
+
+
+/* Structures describe the layout only, fields are serialized in little endian */
+#define CONTAINER_HDR_SZ sizeof(container_hdr_t)
+#define CONTAINER_ENT_SZ sizeof(container_ent_t)
+
+/* App flags, see syspage.h */
+#define FLAG_EXEC   0x01
+#define FLAG_NOCOPY 0x02
+
+
+typedef struct {
+	const char *path;
+	uint8_t *data;
+	uint32_t size;
+	uint32_t offs;
+	uint8_t type;
+	uint8_t flags;
+	char name[sizeof(((container_ent_t *)0)->name)];
+	char imaps[sizeof(((container_ent_t *)0)->imaps)];
+	char dmaps[sizeof(((container_ent_t *)0)->dmaps)];
+} entry_t;
+
+
+static struct {
+	entry_t ents[CONTAINER_MAX_ENTRIES];
+	unsigned int count;
+	uint32_t align;
+} mkc_common;
+
+
+static uint32_t mkc_crc32(const uint8_t *buf, size_t len)
+{
+	uint32_t crc = 0xffffffffu;
+	int i;
+
+	while (len-- > 0) {
+		crc ^= *buf++;
+		for (i = 0; i < 8; i++) {
+			crc = (crc >> 1) ^ (0xedb88320u & -(crc & 1u));
+		}
+	}
+
+	return ~crc;
+}
+
+
+static void mkc_put16(uint8_t *p, uint16_t v)
+{
+	p[0] = v & 0xff;
+	p[1] = (v >> 8) & 0xff;
+}
+
+
+static void mkc_put32(uint8_t *p, uint32_t v)
+{
+	mkc_put16(p, v & 0xffff);
+	mkc_put16(p + 2, v >> 16);
+}
+
+
+static int mkc_strSet(char *dst, size_t sz, const char *src, const char *what)
+{
+	if (strlen(src) >= sz) {
+		fprintf(stderr, "mkcontainer: %s too long (max %zu): %s\n", what, sz - 1, src);
+		return -1;
+	}
+	strcpy(dst, src);
+
+	return 0;
+}
+
+
+static int mkc_fileRead(entry_t *ent)
+{
+	FILE *f;
+	long sz;
+
+	f = fopen(ent->path, "rb");
+	if (f == NULL) {
+		fprintf(stderr, "mkcontainer: can't open %s: %s\n", ent->path, strerror(errno));
+		return -1;
+	}
+
+	if ((fseek(f, 0, SEEK_END) != 0) || ((sz = ftell(f)) < 0) || (fseek(f, 0, SEEK_SET) != 0)) {
+		fprintf(stderr, "mkcontainer: can't get size of %s\n", ent->path);
+		fclose(f);
+		return -1;
+	}
+
+	ent->size = (uint32_t)sz;
+	ent->data = malloc((sz != 0) ? sz : 1);
+	if ((ent->data == NULL) || (fread(ent->data, 1, sz, f) != (size_t)sz)) {
+		fprintf(stderr, "mkcontainer: can't read %s\n", ent->path);
+		fclose(f);
+		return -1;
+	}
+	fclose(f);
+
+	return 0;
+}
+
+
+/* Parses "<file>,<field>,<field>[,<field>...]" in place */
+static int mkc_split(char *arg, char **fields, int max)
+{
+	int n = 0;
+
+	fields[n++] = arg;
+	while ((arg = strchr(arg, ',')) != NULL) {
+		*arg++ = '\0';
+		if (n == max) {
+			return -1;
+		}
+		fields[n++] = arg;
+	}
+
+	return n;
+}
+
+
+static int mkc_entryAdd(char *arg, int type)
+{
+	char *fields[5];
+	const char *base;
+	entry_t *ent;
+	int n;
+
+	if (mkc_common.count >= CONTAINER_MAX_ENTRIES) {
+		fprintf(stderr, "mkcontainer: too many entries, the loader accepts up to %d\n", CONTAINER_MAX_ENTRIES);
+		return -1;
+	}
+
+	ent = &mkc_common.ents[mkc_common.count];
+	ent->type = type;
+	n = mkc_split(arg, fields, 5);
+
+	if (type == container_blob) {
+		/* <file>,<map>[,<name>] */
+		if ((n != 2) && (n != 3)) {
+			return -1;
+		}
+
+		base = strrchr(fields[0], '/');
+		base = (base != NULL) ? (base + 1) : fields[0];
+		if ((mkc_strSet(ent->imaps, sizeof(ent->imaps), fields[1], "map") < 0) ||
+				(mkc_strSet(ent->name, sizeof(ent->name), (n == 3) ? fields[2] : base, "name") < 0)) {
+			return -1;
+		}
+	}
+	else {
+		/* <file>,<argv>,<imaps>,<dmaps>[,x|xn] */
+		if ((n != 4) && (n != 5)) {
+			return -1;
+		}
+
+		if (n == 5) {
+			if (strcmp(fields[4], "x") == 0) {
+				ent->flags = FLAG_EXEC;
+			}
+			else if (strcmp(fields[4], "xn") == 0) {
+				ent->flags = FLAG_EXEC | FLAG_NOCOPY;
+			}
+			else {
+				return -1;
+			}
+		}
+
+		if ((mkc_strSet(ent->name, sizeof(ent->name), fields[1], "argv") < 0) ||
+				(mkc_strSet(ent->imaps, sizeof(ent->imaps), fields[2], "imaps") < 0) ||
+				(mkc_strSet(ent->dmaps, sizeof(ent->dmaps), fields[3], "dmaps") < 0)) {
+			return -1;
+		}
+	}
+
+	ent->path = fields[0];
+	if (mkc_fileRead(ent) < 0) {
+		return -1;
+	}
+
+	mkc_common.count++;
+
+	return 0;
+}
+
+
+static int mkc_write(const char *path)
+{
+	static const uint8_t pad[4096];
+	uint8_t hdr[CONTAINER_HDR_SZ];
+	uint8_t *table, *p;
+	uint32_t tableSz, offs;
+	unsigned int i;
+	FILE *f;
+	int res = 0;
+
+	tableSz = mkc_common.count * CONTAINER_ENT_SZ;
+	table = calloc(1, (tableSz != 0) ? tableSz : 1);
+	if (table == NULL) {
+		fprintf(stderr, "mkcontainer: out of memory\n");
+		return -1;
+	}
+
+	/* Images follow the table in the command line order */
+	offs = CONTAINER_HDR_SZ + tableSz;
+	for (i = 0; i < mkc_common.count; i++) {
+		offs = (offs + mkc_common.align - 1) & ~(mkc_common.align - 1);
+		mkc_common.ents[i].offs = offs;
+		offs += mkc_common.ents[i].size;
+
+		p = table + i * CONTAINER_ENT_SZ;
+		mkc_put32(p + offsetof(container_ent_t, offs), mkc_common.ents[i].offs);
+		mkc_put32(p + offsetof(container_ent_t, size), mkc_common.ents[i].size);
+		mkc_put32(p + offsetof(container_ent_t, crc), mkc_crc32(mkc_common.ents[i].data, mkc_common.ents[i].size));
+		p[offsetof(container_ent_t, type)] = mkc_common.ents[i].type;
+		p[offsetof(container_ent_t, flags)] = mkc_common.ents[i].flags;
+		memcpy(p + offsetof(container_ent_t, name), mkc_common.ents[i].name, sizeof(mkc_common.ents[i].name));
+		memcpy(p + offsetof(container_ent_t, imaps), mkc_common.ents[i].imaps, sizeof(mkc_common.ents[i].imaps));
+		memcpy(p + offsetof(container_ent_t, dmaps), mkc_common.ents[i].dmaps, sizeof(mkc_common.ents[i].dmaps));
+	}
+
+	mkc_put32(hdr + offsetof(container_hdr_t, magic), CONTAINER_MAGIC);
+	mkc_put16(hdr + offsetof(container_hdr_t, version), CONTAINER_VERSION);
+	mkc_put16(hdr + offsetof(container_hdr_t, count), mkc_common.count);
+	mkc_put32(hdr + offsetof(container_hdr_t, size), CONTAINER_HDR_SZ + tableSz);
+	mkc_put32(hdr + offsetof(container_hdr_t, crc), mkc_crc32(table, tableSz));
+
+	f = fopen(path, "wb");
+	if (f == NULL) {
+		fprintf(stderr, "mkcontainer: can't create %s: %s\n", path, strerror(errno));
+		free(table);
+		return -1;
+	}
+
+	offs = CONTAINER_HDR_SZ + tableSz;
+	if ((fwrite(hdr, 1, sizeof(hdr), f) != sizeof(hdr)) || (fwrite(table, 1, tableSz, f) != tableSz)) {
+		res = -1;
+	}
+
+	for (i = 0; (res == 0) && (i < mkc_common.count); i++) {
+		if ((fwrite(pad, 1, mkc_common.ents[i].offs - offs, f) != mkc_common.ents[i].offs - offs) ||
+				(fwrite(mkc_common.ents[i].data, 1, mkc_common.ents[i].size, f) != mkc_common.ents[i].size)) {
+			res = -1;
+		}
+		offs = mkc_common.ents[i].offs + mkc_common.ents[i].size;
+	}
+
+	if ((fclose(f) != 0) || (res < 0)) {
+		fprintf(stderr, "mkcontainer: can't write %s\n", path);
+		res = -1;
+	}
+
+	free(table);
+
+	return res;
+}
+
+
+static void mkc_usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s -o <output> [-A <align>] <entry>...\n", prog);
+	fprintf(stderr, "  -o <output>  container file\n");
+	fprintf(stderr, "  -A <align>   image alignment, power of 2 up to 4096 (default 4096)\n");
+	fprintf(stderr, "  -p <file>,<argv>,<imaps>,<dmaps>[,x|xn]\n");
+	fprintf(stderr, "               app, arguments as for the app command (e.g. psh;-i,ocram2,ocram2)\n");
+	fprintf(stderr, "  -b <file>,<map>[,<name>]\n");
+	fprintf(stderr, "               blob, named after the file by default\n");
+}
+
+
+int main(int argc, char *argv[])
+{
+	const char *out = NULL;
+	char *endptr;
+	int c;
+
+	mkc_common.align = 4096;
+
+	while ((c = getopt(argc, argv, "o:A:p:b:h")) != -1) {
+		switch (c) {
+			case 'o':
+				out = optarg;
+				break;
+
+			case 'A':
+				mkc_common.align = strtoul(optarg, &endptr, 0);
+				if ((*endptr != '\0') || (mkc_common.align == 0) || (mkc_common.align > 4096) ||
+						((mkc_common.align & (mkc_common.align - 1)) != 0)) {
+					fprintf(stderr, "mkcontainer: invalid alignment %s\n", optarg);
+					return EXIT_FAILURE;
+				}
+				break;
+
+			case 'p':
+			case 'b':
+				if (mkc_entryAdd(optarg, (c == 'p') ? container_app : container_blob) < 0) {
+					fprintf(stderr, "mkcontainer: invalid entry -%c %s\n", c, optarg);
+					return EXIT_FAILURE;
+				}
+				break;
+
+			default:
+				mkc_usage(argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+
+	if ((out == NULL) || (optind != argc) || (mkc_common.count == 0)) {
+		mkc_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	return (mkc_write(out) < 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
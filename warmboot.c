@@ -0,0 +1,196 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Operating system loader
+ *
+ * Manifest of images loaded into memory, preserved over warm reset
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#include <lib/lib.h>
+#include <warmboot.h>
+
+
+#define WARMBOOT_MAGIC   0x424d5257 /* "WRMB" */
+#define WARMBOOT_ENTRIES 32
+
+
+typedef struct {
+	u32 name; /* crc32 of the image name */
+	u32 crc;
+	addr_t start;
+	size_t size;
+	warmboot_src_t src;
+} warmboot_entry_t;
+
+
+typedef struct {
+	u32 magic;
+	u32 count;
+	warmboot_entry_t entries[WARMBOOT_ENTRIES];
+	u32 crc;
+} warmboot_manifest_t;
+
+
+/* Manifest content is random after power-up, its crc tells whether it survived the reset */
+static warmboot_manifest_t warmboot_manifest __attribute__((section(".noinit")));
+
+
+static struct {
+	int enabled;
+} warmboot_common;
+
+
+static u32 warmboot_crc32(const void *data, size_t len)
+{
+	return ~lib_crc32(data, len, 0xffffffff);
+}
+
+
+static u32 warmboot_manifestCrc(void)
+{
+	return warmboot_crc32(&warmboot_manifest, offsetof(warmboot_manifest_t, crc));
+}
+
+
+static int warmboot_isValid(void)
+{
+	return ((warmboot_manifest.magic == WARMBOOT_MAGIC) &&
+		(warmboot_manifest.count <= WARMBOOT_ENTRIES) &&
+		(warmboot_manifest.crc == warmboot_manifestCrc())) ? 1 : 0;
+}
+
+
+static warmboot_entry_t *warmboot_find(u32 name, addr_t start)
+{
+	u32 i;
+
+	for (i = 0; i < warmboot_manifest.count; i++) {
+		if ((warmboot_manifest.entries[i].name == name) && (warmboot_manifest.entries[i].start == start)) {
+			return &warmboot_manifest.entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+
+static void warmboot_reset(void)
+{
+	warmboot_manifest.magic = WARMBOOT_MAGIC;
+	warmboot_manifest.count = 0;
+	warmboot_manifest.crc = warmboot_manifestCrc();
+}
+
+
+void warmboot_invalidate(void)
+{
+	/* Called on every storage write, keep it cheap */
+	warmboot_manifest.magic = 0;
+}
+
+
+void warmboot_enable(void)
+{
+	warmboot_common.enabled = 1;
+}
+
+
+void warmboot_srcInit(handler_t handler, addr_t offs, u32 crc, warmboot_src_t *src)
+{
+	addr_t base;
+
+	if (phfs_aliasAddrResolve(handler, &base) < 0) {
+		base = 0;
+	}
+
+	src->dev = handler.pd;
+	src->offs = (u32)(base + offs);
+	src->crc = crc;
+}
+
+
+int warmboot_check(const char *name, addr_t start, size_t size, const warmboot_src_t *src)
+{
+	const warmboot_entry_t *entry;
+
+	if ((warmboot_common.enabled == 0) || (warmboot_isValid() == 0)) {
+		return -ENOENT;
+	}
+
+	entry = warmboot_find(warmboot_crc32(name, hal_strlen(name)), start);
+	if ((entry == NULL) || (entry->size != size)) {
+		return -ENOENT;
+	}
+
+	/* Image stored on the device may have been updated by the previous system run */
+	if ((entry->src.dev != src->dev) || (entry->src.offs != src->offs) || (entry->src.crc != src->crc)) {
+		return -ENOENT;
+	}
+
+	if (warmboot_crc32((const void *)start, size) != entry->crc) {
+		return -EIO;
+	}
+
+	log_info("\nReusing %s at 0x%p from memory", name, (void *)start);
+
+	return EOK;
+}
+
+
+void warmboot_add(const char *name, addr_t start, size_t size, const warmboot_src_t *src)
+{
+	warmboot_entry_t *entry;
+	u32 nameCrc;
+
+	if (warmboot_common.enabled == 0) {
+		return;
+	}
+
+	if (warmboot_isValid() == 0) {
+		warmboot_reset();
+	}
+
+	nameCrc = warmboot_crc32(name, hal_strlen(name));
+	entry = warmboot_find(nameCrc, start);
+	if (entry == NULL) {
+		if (warmboot_manifest.count >= WARMBOOT_ENTRIES) {
+			log_error("\nwarmboot: Manifest full, %s not recorded", name);
+			return;
+		}
+		entry = &warmboot_manifest.entries[warmboot_manifest.count++];
+	}
+
+	entry->name = nameCrc;
+	entry->start = start;
+	entry->size = size;
+	entry->src = *src;
+	entry->crc = warmboot_crc32((const void *)start, size);
+
+	warmboot_manifest.crc = warmboot_manifestCrc();
+}
+
+
+void warmboot_show(void)
+{
+	u32 i;
+	const warmboot_entry_t *entry;
+
+	if (warmboot_isValid() == 0) {
+		lib_printf("\nwarmboot: No valid manifest");
+		return;
+	}
+
+	lib_printf("\nwarmboot: %s", (warmboot_common.enabled != 0) ? "enabled" : "disabled");
+	lib_printf(CONSOLE_BOLD "\n%-10s %-10s %-10s %-10s %-4s %-10s %-10s\n" CONSOLE_NORMAL, "NAME", "START", "SIZE", "CRC", "DEV", "OFFS", "SRC CRC");
+	for (i = 0; i < warmboot_manifest.count; i++) {
+		entry = &warmboot_manifest.entries[i];
+		lib_printf("0x%08x 0x%08x 0x%08x 0x%08x %-4u 0x%08x 0x%08x\n", entry->name, (u32)entry->start, (u32)entry->size, entry->crc,
+			entry->src.dev, entry->src.offs, entry->src.crc);
+	}
+}
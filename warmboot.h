@@ -0,0 +1,54 @@
+/*
+ * Phoenix-RTOS
+ *
+ * Operating system loader
+ *
+ * Manifest of images loaded into memory, preserved over warm reset
+ *
+ * Copyright 2026 Phoenix Systems
+ *
+ * This file is part of Phoenix-RTOS.
+ *
+ * %LICENSE%
+ */
+
+#ifndef WARMBOOT_H_
+#define WARMBOOT_H_
+
+#include <hal/hal.h>
+#include <phfs/phfs.h>
+
+
+/* Identifies stored image the memory copy was loaded from */
+typedef struct {
+	u32 dev;  /* phfs device descriptor */
+	u32 offs; /* absolute image offset on the device */
+	u32 crc;  /* CRC-32 of the whole stored image, kept in storage with the image */
+} warmboot_src_t;
+
+
+/* Enables reuse and recording of loaded images for this boot */
+extern void warmboot_enable(void);
+
+
+/* Drops all recorded images */
+extern void warmboot_invalidate(void);
+
+
+/* Describes image source. Only images stored with a digest of their whole content can be reused,
+ * the stored image may have been updated by the previous system run */
+extern void warmboot_srcInit(handler_t handler, addr_t offs, u32 crc, warmboot_src_t *src);
+
+
+/* Checks whether image loaded from src is still present in memory, returns EOK if it can be reused */
+extern int warmboot_check(const char *name, addr_t start, size_t size, const warmboot_src_t *src);
+
+
+/* Records image loaded into memory from src */
+extern void warmboot_add(const char *name, addr_t start, size_t size, const warmboot_src_t *src);
+
+
+extern void warmboot_show(void);
+
+
+#endif